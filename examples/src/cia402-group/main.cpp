@@ -0,0 +1,132 @@
+#include <modm-canopen/device/canopen_device_group.hpp>
+#include <modm-canopen/cia402/cia402_protocol.hpp>
+#include <modm-canopen/generated/test_od.hpp>
+#include <modm/platform/can/socketcan.hpp>
+
+#include <thread>
+#include <utility>
+#include <modm/debug/logger.hpp>
+
+using modm_canopen::Address;
+using modm_canopen::CanopenDeviceGroup;
+using modm_canopen::SdoErrorCode;
+using modm_canopen::cia402::CiA402;
+using modm_canopen::generated::test_OD;
+
+// Simulates DriveCount CiA402 drives with node ids 5.. on vcan0, e.g. to test a master against a
+// small network. Every drive is a separate instantiation, keep DriveCount to a handful.
+
+static constexpr std::size_t DriveCount = 4;
+
+template<std::size_t Instance = 0>
+struct Test
+{
+	template<std::size_t I>
+	using ForInstance = Test<I>;
+
+	static inline uint32_t value2002 = 42;
+
+	template<typename Device, typename MessageCallback>
+	static void
+	update(MessageCallback&&)
+	{}
+
+	template<typename Device, typename MessageCallback>
+	static void
+	processMessage(const modm::can::Message&, MessageCallback&&)
+	{}
+
+	template<typename ObjectDictionary>
+	constexpr void
+	registerHandlers(modm_canopen::HandlerMap<ObjectDictionary>& map)
+	{
+		map.template setReadHandler<Address{0x2001, 0}>(+[]() { return uint8_t(Instance); });
+
+		map.template setReadHandler<Address{0x2002, 0}>(+[]() { return value2002; });
+
+		map.template setWriteHandler<Address{0x2002, 0}>(+[](uint32_t value) {
+			value2002 = value;
+			return SdoErrorCode::NoError;
+		});
+	}
+};
+
+using Group = CanopenDeviceGroup<test_OD, DriveCount, Test<>, CiA402<0>>;
+
+/// Ideal motor following the demand of the drive
+template<typename Drive>
+void
+simulateMotor(std::chrono::microseconds timestep)
+{
+	static typename Drive::Inputs inputs{};
+	const auto outputs = Drive::getOutputs();
+	if (outputs.state != modm_canopen::cia402::MotorState::On)
+	{
+		inputs.velocity = 0;
+	} else if (outputs.mode == modm_canopen::cia402::ControlMode::Velocity)
+	{
+		inputs.velocity = outputs.demand.velocity;
+		inputs.position += int64_t(inputs.velocity) * timestep.count() / 1'000'000;
+	} else if (outputs.mode == modm_canopen::cia402::ControlMode::Position)
+	{
+		inputs.position = outputs.demand.position;
+	}
+	Drive::updateInputs(inputs);
+}
+
+template<std::size_t... Instances>
+void
+simulateMotors(std::chrono::microseconds timestep, std::index_sequence<Instances...>)
+{
+	(simulateMotor<CiA402<0, Instances>>(timestep), ...);
+}
+
+int
+main()
+{
+	Group::initialize(5, modm_canopen::Identity{.deviceType_ = 402,
+												.vendorId_ = 0xdeadbeef,
+												.productCode_ = 0,
+												.revisionId_ = 1,
+												.serialNumber_ = 1});
+
+	modm::platform::SocketCan can;
+	const bool success = can.open("vcan0");
+	if (!success) { MODM_LOG_ERROR << "Opening device vcan0 failed" << modm::endl; }
+
+	auto sendMessage = [&can](const modm::can::Message& message) { can.sendMessage(message); };
+
+	auto lastUpdate = modm::PreciseClock::now();
+	while (true)
+	{
+		if (can.isMessageAvailable())
+		{
+			modm::can::Message message{};
+			can.getMessage(message);
+			if (message.isExtended())
+			{
+				message.identifier &= 0x1FFFFFFF;
+			} else
+			{
+				message.identifier &= 0x7FF;
+			}
+			Group::processMessage(message, sendMessage);
+		}
+		const auto now = modm::PreciseClock::now();
+		simulateMotors(std::chrono::microseconds{(now - lastUpdate).count()},
+					   std::make_index_sequence<DriveCount>{});
+		lastUpdate = now;
+		const auto deadline = Group::update(sendMessage);
+
+		// Sleep until a device needs the next update, but keep polling for received frames
+		if (!can.isMessageAvailable())
+		{
+			const std::chrono::microseconds remaining{int32_t((deadline - now).count())};
+			const std::chrono::microseconds pollInterval{1000};
+			if (remaining.count() > 0)
+			{
+				std::this_thread::sleep_for(std::min(remaining, pollInterval));
+			}
+		}
+	}
+}
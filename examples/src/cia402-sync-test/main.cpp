@@ -0,0 +1,183 @@
+#include <modm-canopen/device/canopen_device.hpp>
+#include <modm-canopen/cia402/cia402_protocol.hpp>
+#include <modm-canopen/generated/test_od.hpp>
+#include <modm/debug/logger.hpp>
+
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using modm_canopen::Address;
+using modm_canopen::CanopenDevice;
+using modm_canopen::SdoErrorCode;
+using modm_canopen::Value;
+using modm_canopen::cia402::CiA402;
+using modm_canopen::generated::test_OD;
+
+// Host side check of the CiA402 control step scheduling without a CAN bus: SYNC frames are fed
+// to the device directly. Without SYNC the control step runs every millisecond, phase locked to
+// the SYNC once per period shortly before it, and when the SYNC stops it falls back to the
+// timer. Exits with 1 if any phase fails.
+
+struct Test
+{
+	template<typename Device, typename MessageCallback>
+	static void
+	update(MessageCallback&&)
+	{}
+
+	template<typename Device, typename MessageCallback>
+	static void
+	processMessage(const modm::can::Message&, MessageCallback&&)
+	{}
+
+	template<typename ObjectDictionary>
+	constexpr void
+	registerHandlers(modm_canopen::HandlerMap<ObjectDictionary>& map)
+	{
+		map.template setReadHandler<Address{0x2001, 0}>(+[]() { return uint8_t(10); });
+		map.template setReadHandler<Address{0x2002, 0}>(+[]() { return uint32_t(42); });
+		map.template setWriteHandler<Address{0x2002, 0}>(
+			+[](uint32_t) { return SdoErrorCode::NoError; });
+	}
+};
+
+using Drive = CiA402<0>;
+using Device = CanopenDevice<test_OD, Test, Drive>;
+
+static constexpr std::chrono::microseconds SyncPeriod{4000};
+static constexpr int32_t Acceleration = 1'000'000;  // one unit of velocity per microsecond
+
+using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+
+/// Times of the control steps, detected by the velocity ramp moving on
+struct Run
+{
+	std::vector<modm::PreciseClock::time_point> steps;
+	std::vector<modm::PreciseClock::time_point> syncs;
+};
+
+Run
+run(std::chrono::milliseconds duration, bool sendSync)
+{
+	const auto noop = [](const modm::can::Message&) {};
+	Run result;
+	const auto start = modm::PreciseClock::now();
+	auto nextSync = start;
+	int32_t velocity = Drive::getOutputs().demand.velocity;
+	while (true)
+	{
+		const auto now = modm::PreciseClock::now();
+		if (SignedRep((now - start).count()) >= SignedRep(duration.count() * 1000)) break;
+		if (sendSync && SignedRep((now - nextSync).count()) >= 0)
+		{
+			Device::processMessage(modm::can::Message{0x80, 0}, noop);
+			result.syncs.push_back(now);
+			nextSync += SyncPeriod;
+		}
+		Device::update(noop);
+		if (Drive::getOutputs().demand.velocity != velocity)
+		{
+			velocity = Drive::getOutputs().demand.velocity;
+			result.steps.push_back(modm::PreciseClock::now());
+		}
+		std::this_thread::yield();
+	}
+	return result;
+}
+
+/// Number of control steps in [begin, end)
+std::size_t
+stepsBetween(const Run& run, modm::PreciseClock::time_point begin,
+			 modm::PreciseClock::time_point end)
+{
+	std::size_t count = 0;
+	for (const auto step : run.steps)
+	{
+		count += SignedRep((step - begin).count()) >= 0 && SignedRep((end - step).count()) > 0;
+	}
+	return count;
+}
+
+int
+main()
+{
+	Device::initialize(5, modm_canopen::Identity{});
+	const auto noop = [](const modm::can::Message&) {};
+	modm::can::Message start{0, 2};
+	start.setExtended(false);
+	start.data[0] = 1;  // NMT start remote node
+	start.data[1] = 5;
+	Device::processMessage(start, noop);
+
+	// SYNC consumer, profile velocity mode ramping towards a target far away
+	Device::write(Address{0x1005, 0}, Value{uint32_t(0x80)});
+	Device::write(Address{0x1006, 0}, Value{uint32_t(SyncPeriod.count())});
+	Device::write(Address{0x6083, 0}, Value{uint32_t(Acceleration)});
+	Device::write(Address{0x6084, 0}, Value{uint32_t(Acceleration)});
+	Device::write(Address{0x60FF, 0}, Value{int32_t(1'000'000'000)});
+	Device::write(Address{0x6060, 0}, Value{int8_t(3)});
+	for (const uint16_t control : {0x6, 0x7, 0xF})
+	{
+		Device::write(Address{0x6040, 0}, Value{uint16_t(control)});
+	}
+
+	int failures = 0;
+
+	// Timer: about one step per millisecond
+	const auto timer = run(50ms, false);
+	if (timer.steps.size() < 40 || timer.steps.size() > 52)
+	{
+		MODM_LOG_ERROR << "FAIL timer: " << timer.steps.size() << " steps in 50 ms" << modm::endl;
+		++failures;
+	}
+
+	// SYNC: after the PLL locked exactly one step per period, before the SYNC
+	const auto synced = run(200ms, true);
+	const std::size_t lockedFrom = synced.syncs.size() / 2;
+	int64_t earliest = 0, latest = -SyncPeriod.count();
+	for (std::size_t i = lockedFrom; i < synced.syncs.size(); ++i)
+	{
+		const auto sync = synced.syncs[i];
+		const std::size_t steps = stepsBetween(synced, synced.syncs[i - 1], sync);
+		for (const auto step : synced.steps)
+		{
+			const SignedRep offset = SignedRep((step - sync).count());
+			if (offset < 0 && offset > -SyncPeriod.count() / 2)
+			{
+				earliest = std::min<int64_t>(earliest, offset);
+				latest = std::max<int64_t>(latest, offset);
+			}
+		}
+		if (steps != 1)
+		{
+			MODM_LOG_ERROR << "FAIL sync: " << steps << " steps in period " << i << modm::endl;
+			++failures;
+		}
+	}
+	// Generous bounds, the host scheduler adds jitter
+	const int64_t offset = Drive::SyncOffset.count();
+	if (earliest < 3 * offset || latest > offset / 4)
+	{
+		MODM_LOG_ERROR << "FAIL sync: steps " << earliest << " to " << latest
+					   << " us before the SYNC" << modm::endl;
+		++failures;
+	}
+
+	// SYNC lost: the communication error stops the node, restarted it is back on the timer
+	run(20ms, false);
+	Device::processMessage(start, noop);
+	const auto lost = run(50ms, false);
+	if (lost.steps.size() < 40 || lost.steps.size() > 52)
+	{
+		MODM_LOG_ERROR << "FAIL fallback: " << lost.steps.size() << " steps in 50 ms"
+					   << modm::endl;
+		++failures;
+	}
+
+	MODM_LOG_INFO << "timer " << timer.steps.size() << " steps in 50 ms, SYNC steps " << -latest
+				  << " to " << -earliest << " us before the SYNC, " << lost.steps.size()
+				  << " steps in 50 ms after the SYNC stopped: " << failures << " failures"
+				  << modm::endl;
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,4 +1,5 @@
 #include <modm-canopen/device/canopen_device.hpp>
+#include <modm-canopen/device/mmap_storage_backend.hpp>
 #include <modm-canopen/generated/test_od.hpp>
 #include <modm/platform/can/socketcan.hpp>
 
@@ -11,6 +12,7 @@ uint32_t value2002 = 42;
 
 using modm_canopen::Address;
 using modm_canopen::CanopenDevice;
+using modm_canopen::ParameterStorage;
 using modm_canopen::SdoErrorCode;
 using modm_canopen::generated::test_OD;
 
@@ -53,6 +55,18 @@ main()
 													  .revisionId_ = 1,
 													  .serialNumber_ = 1});
 
+	// Parameters stored by writing "save" to 0x1010 are restored at the next start
+	modm_canopen::MmapStorageBackend storage{"parameters.bin",
+											 ParameterStorage<Device>::requiredCapacity()};
+	if (storage.isOpen())
+	{
+		ParameterStorage<Device>::setBackend(&storage);
+		if (ParameterStorage<Device>::load())
+		{
+			MODM_LOG_INFO << "Restored stored parameters" << modm::endl;
+		}
+	}
+
 	modm::platform::SocketCan can;
 	const bool success = can.open("vcan0");
 	if (!success) { MODM_LOG_ERROR << "Opening device vcan0 failed" << modm::endl; }
@@ -104,6 +118,18 @@ main()
 			}
 			Device::processMessage(message, sendMessage);
 		}
-		Device::update(sendMessage);
+		const auto deadline = Device::update(sendMessage);
+
+		// Sleep until the device needs the next update, but keep polling for received frames
+		if (!can.isMessageAvailable())
+		{
+			const auto now = modm::PreciseClock::now();
+			const std::chrono::microseconds remaining{int32_t((deadline - now).count())};
+			const std::chrono::microseconds pollInterval{1000};
+			if (remaining.count() > 0)
+			{
+				std::this_thread::sleep_for(std::min(remaining, pollInterval));
+			}
+		}
 	}
 }
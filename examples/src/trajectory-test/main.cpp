@@ -0,0 +1,211 @@
+#include <modm-canopen/cia402/trajectory.hpp>
+#include <modm/debug/logger.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <random>
+
+using modm_canopen::cia402::BasicTrajectory;
+using modm_canopen::cia402::DoubleArithmetic;
+using modm_canopen::cia402::FixedPointArithmetic;
+
+// Host side checks of the trajectory planner: limits are kept, the position follows the velocity
+// and the target is reached, and the fixed-point evaluation follows the double precision one on
+// every tick. Exits with 1 if any case fails.
+
+struct Case
+{
+	int32_t position;
+	int32_t velocity;
+	int32_t target;
+	uint32_t maxVelocity;
+	uint32_t maxAcceleration;
+	uint32_t maxJerk;
+};
+
+static constexpr uint32_t Timestep = 1000;  // us
+
+template<typename Arithmetic>
+bool
+check(const Case& c)
+{
+	BasicTrajectory<Arithmetic> trajectory;
+	trajectory.setProfile(c.maxVelocity, c.maxAcceleration, c.maxJerk);
+	trajectory.reset(c.position, c.velocity);
+	if (!trajectory.setTarget(c.target)) return false;
+
+	// Starting above the velocity limit slows down first
+	const int64_t velocityLimit = std::max<int64_t>(c.maxVelocity, std::abs(int64_t(c.velocity)));
+	int64_t maxVelocity = 0, maxAcceleration = 0, maxJerk = 0, maxDeviation = 0;
+	int32_t lastPosition = c.position, lastVelocity = c.velocity, lastAcceleration = 0;
+	const uint64_t steps = trajectory.duration() / Timestep + 2;
+	for (uint64_t step = 0; step < steps && !trajectory.isDone(); ++step)
+	{
+		trajectory.update(Timestep);
+		maxVelocity = std::max<int64_t>(maxVelocity, std::abs(trajectory.velocity()));
+		maxAcceleration = std::max<int64_t>(maxAcceleration, std::abs(trajectory.acceleration()));
+		if (step != 0)
+		{
+			const int64_t jerk = int64_t(trajectory.acceleration()) - lastAcceleration;
+			maxJerk = std::max<int64_t>(maxJerk, std::abs(jerk) * (1'000'000 / Timestep));
+		}
+		// Trapezoidal rule, exact for constant acceleration
+		const int64_t expected =
+			(int64_t(lastVelocity) + trajectory.velocity()) * Timestep / 2'000'000;
+		const int64_t moved = int32_t(uint32_t(trajectory.position()) - uint32_t(lastPosition));
+		maxDeviation = std::max<int64_t>(maxDeviation, std::abs(moved - expected));
+		lastPosition = trajectory.position();
+		lastVelocity = trajectory.velocity();
+		lastAcceleration = trajectory.acceleration();
+	}
+
+	// Rounding of the outputs adds one unit per step to the jerk
+	const bool ok = trajectory.isDone() && trajectory.position() == c.target &&
+					maxVelocity <= velocityLimit * 101 / 100 + 1 &&
+					maxAcceleration <= int64_t(c.maxAcceleration) * 101 / 100 + 1 &&
+					(c.maxJerk == 0 ||
+					 maxJerk <= int64_t(c.maxJerk) * 102 / 100 + 2 * (1'000'000 / Timestep)) &&
+					maxDeviation <= 2;
+	if (!ok)
+	{
+		MODM_LOG_ERROR << "FAIL " << c.position << " @ " << c.velocity << " -> " << c.target
+					   << ": velocity " << maxVelocity << " acceleration " << maxAcceleration
+					   << " jerk " << maxJerk << " deviation " << maxDeviation << " final "
+					   << trajectory.position() << modm::endl;
+	}
+	return ok;
+}
+
+/// Runs both arithmetics in lockstep, the fixed-point outputs must stay within the tolerances of
+/// the double precision ones on every tick. Positions are compared modulo 2^32.
+bool
+compare(const Case& c)
+{
+	// tau in Q31 resolves a segment across the whole int32 range to two units
+	constexpr int64_t PositionTolerance = 2;
+	constexpr int64_t Tolerance = 1;
+	BasicTrajectory<DoubleArithmetic> reference;
+	BasicTrajectory<FixedPointArithmetic> fixed;
+	reference.setProfile(c.maxVelocity, c.maxAcceleration, c.maxJerk);
+	fixed.setProfile(c.maxVelocity, c.maxAcceleration, c.maxJerk);
+	reference.reset(c.position, c.velocity);
+	fixed.reset(c.position, c.velocity);
+	reference.setTarget(c.target);
+	fixed.setTarget(c.target);
+
+	int64_t maxPosition = 0, maxVelocity = 0, maxAcceleration = 0;
+	const uint64_t steps = reference.duration() / Timestep + 2;
+	for (uint64_t step = 0; step < steps; ++step)
+	{
+		reference.update(Timestep);
+		fixed.update(Timestep);
+		const int32_t position =
+			int32_t(uint32_t(fixed.position()) - uint32_t(reference.position()));
+		maxPosition = std::max<int64_t>(maxPosition, std::abs(int64_t(position)));
+		maxVelocity = std::max<int64_t>(
+			maxVelocity, std::abs(int64_t(fixed.velocity()) - reference.velocity()));
+		maxAcceleration = std::max<int64_t>(
+			maxAcceleration, std::abs(int64_t(fixed.acceleration()) - reference.acceleration()));
+	}
+
+	const bool ok = maxPosition <= PositionTolerance && maxVelocity <= Tolerance &&
+					maxAcceleration <= Tolerance && fixed.isDone() == reference.isDone();
+	if (!ok)
+	{
+		MODM_LOG_ERROR << "MISMATCH " << c.position << " @ " << c.velocity << " -> " << c.target
+					   << ": position " << maxPosition << " velocity " << maxVelocity
+					   << " acceleration " << maxAcceleration << modm::endl;
+	}
+	return ok;
+}
+
+static constexpr int32_t Min = std::numeric_limits<int32_t>::min();
+static constexpr int32_t Max = std::numeric_limits<int32_t>::max();
+
+/// Cases for check() and compare()
+template<typename Visitor>
+int
+forAllCases(Visitor&& visit)
+{
+	const Case cases[] = {
+		{0, 0, 100'000, 10'000, 20'000, 100'000},
+		{0, 0, 1'000, 10'000, 20'000, 100'000},
+		{0, 0, 10, 10'000, 20'000, 100'000},
+		{0, 0, -100'000, 10'000, 20'000, 100'000},
+		{0, 5'000, 100'000, 10'000, 20'000, 100'000},
+		{0, 9'000, 3'000, 10'000, 20'000, 100'000},
+		{0, -5'000, 10'000, 10'000, 20'000, 100'000},
+		{0, 20'000, 100'000, 10'000, 20'000, 100'000},
+		{0, 20'000, 12'000, 10'000, 20'000, 100'000},
+		{0, 5'000, 0, 10'000, 20'000, 100'000},
+		// Trapezoidal
+		{0, 0, 100'000, 10'000, 20'000, 0},
+		// Far from zero and long cruise segments
+		{1'000'000'000, 0, 1'001'000'000, 100'000, 200'000, 1'000'000},
+		{-1'000'000'000, 0, 1'000'000'000, 1'000'000, 2'000'000, 10'000'000},
+		// Full int32 range and overshooting the range end, the outputs wrap around
+		{Min, 0, Max, 1'000'000, 10'000'000, 100'000'000},
+		{Max, 0, Min, 1'000'000, 10'000'000, 100'000'000},
+		{Max - 1'000, 1'000'000, Max - 1'000, 1'000'000, 2'000'000, 10'000'000},
+		{Min + 1'000, -1'000'000, Min + 1'000, 1'000'000, 2'000'000, 10'000'000},
+	};
+	int failures = 0;
+	for (const auto& c : cases) { failures += !visit(c); }
+
+	std::mt19937 random{1};
+	const auto uniform = [&random](int32_t min, int32_t max) {
+		return std::uniform_int_distribution<int32_t>{min, max}(random);
+	};
+	for (int i = 0; i < 2000; ++i)
+	{
+		Case c{};
+		c.position = uniform(-50'000, 50'000);
+		c.velocity = uniform(-10'000, 10'000);
+		c.target = uniform(-50'000, 50'000);
+		c.maxVelocity = uniform(1'000, 20'000);
+		c.maxAcceleration = uniform(1'000, 50'000);
+		c.maxJerk = uniform(5'000, 500'000);
+		failures += !visit(c);
+	}
+	return failures;
+}
+
+/// Average time of one update() in ns
+template<typename Arithmetic>
+double
+benchmark()
+{
+	constexpr int Updates = 1'000'000;
+	BasicTrajectory<Arithmetic> trajectory;
+	trajectory.setProfile(10'000, 20'000, 100'000);
+	trajectory.reset(0);
+	trajectory.setTarget(1'000'000'000);
+
+	[[maybe_unused]] volatile int32_t sink{};
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Updates; ++i)
+	{
+		trajectory.update(Timestep);
+		sink = trajectory.position();
+	}
+	const std::chrono::duration<double, std::nano> elapsed =
+		std::chrono::steady_clock::now() - start;
+	return elapsed.count() / Updates;
+}
+
+int
+main()
+{
+	const int doubleFailures = forAllCases(check<DoubleArithmetic>);
+	const int fixedFailures = forAllCases(check<FixedPointArithmetic>);
+	const int mismatches = forAllCases(compare);
+	MODM_LOG_INFO << "DoubleArithmetic: " << doubleFailures << " failures, "
+				  << benchmark<DoubleArithmetic>() << " ns per update" << modm::endl;
+	MODM_LOG_INFO << "FixedPointArithmetic: " << fixedFailures << " failures, "
+				  << benchmark<FixedPointArithmetic>() << " ns per update" << modm::endl;
+	MODM_LOG_INFO << "FixedPointArithmetic against DoubleArithmetic: " << mismatches
+				  << " mismatches" << modm::endl;
+	return (doubleFailures == 0 && fixedFailures == 0 && mismatches == 0) ? EXIT_SUCCESS
+																		  : EXIT_FAILURE;
+}
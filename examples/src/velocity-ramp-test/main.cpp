@@ -0,0 +1,161 @@
+#include <modm-canopen/cia402/velocity_ramp.hpp>
+#include <modm/debug/logger.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+using modm_canopen::cia402::ProfileType;
+using modm_canopen::cia402::VelocityRamp;
+
+// Host side checks of the velocity ramp: acceleration and deceleration limits are kept, a sign
+// reversal passes through zero without overshooting and the target is reached in time. A rate
+// of 0 jumps to the target. Exits with 1 if any case fails.
+
+struct Case
+{
+	ProfileType profile;
+	int32_t velocity;
+	int32_t target;
+	uint32_t acceleration;
+	uint32_t deceleration;
+};
+
+static constexpr uint32_t Timestep = 1000;  // us
+
+bool
+check(const Case& c)
+{
+	VelocityRamp ramp;
+	ramp.reset(c.velocity);
+	ramp.setTarget(c.target, c.acceleration, c.deceleration, c.profile);
+
+	const bool sin2 = c.profile == ProfileType::Sin2Ramp;
+	const bool reversing = (c.velocity > 0 && c.target < 0) || (c.velocity < 0 && c.target > 0);
+	const bool slowing = reversing || std::abs(int64_t(c.target)) < std::abs(int64_t(c.velocity));
+	// sin² ramps the whole way with one rate, the linear ramp switches at zero
+	const auto rateFor = [&](int32_t from, int32_t to) -> int64_t {
+		if (sin2) return slowing ? c.deceleration : c.acceleration;
+		const bool towardsZero = std::abs(int64_t(to)) < std::abs(int64_t(from)) ||
+								 (from > 0 && to < 0) || (from < 0 && to > 0);
+		return towardsZero ? c.deceleration : c.acceleration;
+	};
+
+	// Expected duration, sin² keeps the peak acceleration at the rate
+	const int64_t delta = std::abs(int64_t(c.target) - c.velocity);
+	int64_t expected = 0;
+	if (sin2)
+	{
+		const int64_t rate = slowing ? c.deceleration : c.acceleration;
+		expected = (rate == 0) ? 0 : delta * 1'570'796 / rate;
+	} else
+	{
+		const int64_t stop = reversing ? 0 : c.target;
+		const auto duration = [](int64_t distance, int64_t rate) -> int64_t {
+			return (rate == 0) ? 0 : distance * 1'000'000 / rate;
+		};
+		expected = duration(std::abs(stop - c.velocity), slowing ? c.deceleration : c.acceleration);
+		if (reversing) { expected += duration(std::abs(int64_t(c.target)), c.acceleration); }
+	}
+	const int64_t steps = expected / Timestep + 3;
+
+	int32_t last = c.velocity;
+	int64_t excess = 0;
+	bool overshoot = false, zero = !reversing;
+	int64_t step = 0;
+	for (; step < steps && !ramp.isDone(); ++step)
+	{
+		const int32_t velocity = ramp.update(Timestep);
+		const int64_t rate = rateFor(last, velocity);
+		// Rounding adds a unit to both ends of a step, the sin² table has a resolution of 2^-15
+		const int64_t limit = rate * Timestep / 1'000'000 + 2 + (sin2 ? delta >> 14 : 0);
+		if (rate != 0) { excess = std::max(excess, std::abs(int64_t(velocity) - last) - limit); }
+		overshoot |= (c.target >= c.velocity) ? (velocity > c.target || velocity < last)
+											  : (velocity < c.target || velocity > last);
+		zero |= (velocity == 0) || (last < 0) != (velocity < 0);
+		last = velocity;
+	}
+
+	const bool ok = ramp.isDone() && ramp.velocity() == c.target && excess <= 0 && !overshoot &&
+					zero && ((c.acceleration != 0 && c.deceleration != 0) || step <= 1);
+	if (!ok)
+	{
+		MODM_LOG_ERROR << "FAIL " << (sin2 ? "sin2 " : "linear ") << c.velocity << " -> "
+					   << c.target << " @ " << c.acceleration << "/" << c.deceleration
+					   << ": final " << ramp.velocity() << " after " << step << " of " << steps
+					   << " steps, excess " << excess << (overshoot ? ", overshoot" : "")
+					   << (zero ? "" : ", skipped zero") << modm::endl;
+	}
+	return ok;
+}
+
+int
+checkAll(ProfileType profile)
+{
+	const Case cases[] = {
+		{profile, 0, 10'000, 20'000, 20'000},
+		{profile, 0, -10'000, 20'000, 20'000},
+		{profile, 10'000, 0, 20'000, 5'000},
+		{profile, 10'000, 2'000, 20'000, 5'000},
+		// Sign reversal through zero
+		{profile, 10'000, -10'000, 20'000, 5'000},
+		{profile, -10'000, 3'000, 5'000, 20'000},
+		// Rates below one unit per step
+		{profile, 0, 7, 333, 333},
+		{profile, 5, -5, 100, 700},
+		// Rate 0 disables the ramp
+		{profile, 1'000, -1'000, 0, 0},
+		{profile, 0, 1'000, 0, 20'000},
+		{profile, 1'000, 0, 20'000, 0},
+		// Full range
+		{profile, std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::min(),
+		 1'000'000'000, 1'000'000'000},
+	};
+	int failures = 0;
+	for (const auto& c : cases) { failures += !check(c); }
+
+	std::mt19937 random{1};
+	const auto uniform = [&random](int32_t min, int32_t max) {
+		return std::uniform_int_distribution<int32_t>{min, max}(random);
+	};
+	for (int i = 0; i < 2000; ++i)
+	{
+		Case c{};
+		c.profile = profile;
+		c.velocity = uniform(-100'000, 100'000);
+		c.target = uniform(-100'000, 100'000);
+		c.acceleration = uniform(100, 1'000'000);
+		c.deceleration = uniform(100, 1'000'000);
+		failures += !check(c);
+	}
+	return failures;
+}
+
+/// Average time of one update() in ns while ramping
+double
+benchmark(ProfileType profile)
+{
+	constexpr int Updates = 1'000'000;
+	VelocityRamp ramp;
+	ramp.reset(0);
+	ramp.setTarget(std::numeric_limits<int32_t>::max(), 1'000, 1'000, profile);
+
+	[[maybe_unused]] volatile int32_t sink{};
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Updates; ++i) { sink = ramp.update(Timestep); }
+	const std::chrono::duration<double, std::nano> elapsed =
+		std::chrono::steady_clock::now() - start;
+	return elapsed.count() / Updates;
+}
+
+int
+main()
+{
+	const int linearFailures = checkAll(ProfileType::LinearRamp);
+	const int sin2Failures = checkAll(ProfileType::Sin2Ramp);
+	MODM_LOG_INFO << "Linear ramp: " << linearFailures << " failures, "
+				  << benchmark(ProfileType::LinearRamp) << " ns per update" << modm::endl;
+	MODM_LOG_INFO << "sin² ramp: " << sin2Failures << " failures, "
+				  << benchmark(ProfileType::Sin2Ramp) << " ns per update" << modm::endl;
+	return (linearFailures == 0 && sin2Failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+
+namespace modm_canopen::cia402
+{
+
+enum class MotorState
+{
+	On,
+	Idle,
+	Braking
+};
+
+enum class ControlMode
+{
+	Velocity,
+	Voltage,
+	Torque,
+	Position,
+	None,
+};
+
+/// Measurements of one axis passed to the CiA402 protocol
+struct AxisInputs
+{
+	int32_t current[3];  // ma
+	int32_t torque;      // 1/1000 of rated torque (0x6076)
+	int32_t velocity;    // ticks/s
+	int32_t position;    // ticks
+};
+
+/// Demands of the CiA402 protocol for the motor controller of one axis
+struct AxisOutputs
+{
+	MotorState state;
+	ControlMode mode;
+	union {
+		int32_t torque;    // 1/1000 of rated torque (0x6076)
+		int32_t velocity;  // ticks/s
+		int32_t position;  // ticks
+	} demand;
+	// Feed forward of the cyclic synchronous modes (0x60B1, 0x60B2), 0 otherwise
+	struct
+	{
+		int32_t velocity;  // ticks/s
+		int32_t torque;    // 1/1000 of rated torque (0x6076)
+	} feedForward;
+	uint16_t currentLimit;  // ma
+};
+
+}  // namespace modm_canopen::cia402
@@ -0,0 +1,196 @@
+#ifndef CANOPEN_CIA402_MULTI_AXIS_HPP
+#define CANOPEN_CIA402_MULTI_AXIS_HPP
+#include <modm/architecture/interface/can_message.hpp>
+#include <modm/processing/timer.hpp>
+#include "../device/handler_map.hpp"
+#include "axis_io.hpp"
+#include "cia402_objects.hpp"
+#include "scaling_objects.hpp"
+#include "operating_mode.hpp"
+#include "state_machine.hpp"
+#include "option_code.hpp"
+#include "profile_type.hpp"
+#include "factors.hpp"
+#include "../sdo_error.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace modm_canopen::cia402
+{
+
+namespace detail
+{
+template<std::size_t Count, typename T>
+constexpr std::array<T, Count>
+filled(T value)
+{
+	std::array<T, Count> values{};
+	values.fill(value);
+	return values;
+}
+}  // namespace detail
+
+/// CiA402 protocol for AxisCount axes of one device, axis i uses the objects at 0x6000 + 0x800 * i.
+/// Instead of one CiA402<Axis> per axis with its own timer and scattered state, per-axis values
+/// are kept in arrays and the velocity ramps of all axes are computed in one branch-free loop.
+/// Only linear ramps (0x6086 = 0) are supported. All state is static, Instance tells the devices
+/// of a CanopenDeviceGroup apart.
+template<std::size_t AxisCount, std::size_t Instance = 0>
+class CiA402MultiAxis
+{
+	static_assert(AxisCount > 0 && AxisCount <= 8,
+				  "Only 8 axes per device are supported by the CiA402 standard");
+
+public:
+	using Inputs = AxisInputs;
+	using Outputs = AxisOutputs;
+
+	template<std::size_t I>
+	using ForInstance = CiA402MultiAxis<AxisCount, I>;
+
+	static constexpr std::size_t
+	axisCount()
+	{
+		return AxisCount;
+	}
+
+	// Input
+
+	static void
+	setError(std::size_t axis);
+
+	static void
+	updateInputs(std::size_t axis, const Inputs& in);
+
+	// Output
+
+	static Outputs
+	getOutputs(std::size_t axis);
+
+	// Canopen Protocol
+	/// Objects ParameterStorage must not restore
+	static constexpr bool
+	isProcessData(Address address)
+	{
+		return [address]<std::size_t... Axes>(std::index_sequence<Axes...>) {
+			return (CiA402Objects<Axes>::isProcessData(address) || ...);
+		}(std::make_index_sequence<AxisCount>{});
+	}
+
+	/// Returns when the next control step is due
+	template<typename Device, typename MessageCallback>
+	static modm::PreciseClock::time_point
+	update(MessageCallback&&);
+
+	template<typename Device, typename MessageCallback>
+	static void
+	processMessage(const modm::can::Message&, MessageCallback&&)
+	{}
+
+	template<typename ObjectDictionary>
+	constexpr void
+	registerHandlers(HandlerMap<ObjectDictionary>& map);
+
+private:
+	template<typename T>
+	using PerAxis = std::array<T, AxisCount>;
+
+	// Profile velocity only
+	static constexpr uint32_t supportedModesBitfield_ = 0b0000'0000'0000'0000'0000'0000'0000'0100;
+	// Velocities in the ramp are Q24, large enough for any int32_t velocity
+	static constexpr int VelocityFractionBits = 24;
+	static constexpr int64_t NoRampLimit = std::numeric_limits<int64_t>::max() / 2;
+	// Longer time steps are shortened, so the ramp step cannot overflow
+	static constexpr uint32_t MaxTimestep = 65'535;  // us
+
+	static inline PerAxis<StateMachine> status_ = []<std::size_t... Axes>(
+		std::index_sequence<Axes...>) {
+		return PerAxis<StateMachine>{((void)Axes, StateMachine{State::SwitchOnDisabled})...};
+	}(std::make_index_sequence<AxisCount>{});
+	static inline PerAxis<OperatingMode> demandedMode_{};
+	static inline PerAxis<OperatingMode> displayedMode_{};
+
+	static inline PerAxis<OptionCode> shutdownCode_ =
+		detail::filled<AxisCount>(OptionCode::DisableDrive);
+	static inline PerAxis<OptionCode> disableCode_ =
+		detail::filled<AxisCount>(OptionCode::SlowDownWithRamp);
+	static inline PerAxis<OptionCode> quickStopCode_ =
+		detail::filled<AxisCount>(OptionCode::SlowDownWithQuickStopRamp);
+	static inline PerAxis<OptionCode> haltCode_ =
+		detail::filled<AxisCount>(OptionCode::SlowDownWithRamp);
+	static inline PerAxis<OptionCode> faultCode_ =
+		detail::filled<AxisCount>(OptionCode::SlowDownWithQuickStopRamp);
+
+	// Objects, in internal units
+	static inline PerAxis<int32_t> targetVelocity_{};
+	static inline PerAxis<uint32_t> maxProfileVelocity_ =
+		detail::filled<AxisCount>(std::numeric_limits<uint32_t>::max());
+	static inline PerAxis<uint32_t> profileAcceleration_{};
+	static inline PerAxis<uint32_t> profileDeceleration_{};
+	static inline PerAxis<uint32_t> quickStopDeceleration_{};
+
+	// Scaling factors and polarity (0x607E)
+	static inline PerAxis<ScalingFactor> positionEncoderResolution_{};
+	static inline PerAxis<ScalingFactor> velocityEncoderResolution_{};
+	static inline PerAxis<ScalingFactor> gearRatio_{};
+	static inline PerAxis<ScalingFactor> feed_{};
+	static inline PerAxis<ScalingFactor> positionFactor_{};
+	static inline PerAxis<ScalingFactor> velocityEncoderFactor_{};
+	static inline PerAxis<ScalingFactor> velocityFactor1_{};
+	static inline PerAxis<ScalingFactor> velocityFactor2_{};
+	static inline PerAxis<ScalingFactor> accelerationFactor_{};
+	static inline PerAxis<uint8_t> polarity_{};
+
+	// Inputs
+	static inline PerAxis<int32_t> actualVelocity_{};
+	static inline PerAxis<int32_t> actualPosition_{};
+	static inline PerAxis<int32_t> actualTorque_{};
+
+	// Ramp, set up per axis from the state, then computed for all axes at once
+	static inline PerAxis<bool> rampActive_{};
+	static inline PerAxis<bool> stopping_{};
+	static inline PerAxis<OptionCode> stopCode_{};
+	static inline PerAxis<int32_t> rampTarget_{};
+	static inline PerAxis<int64_t> rampAcceleration_{};
+	static inline PerAxis<int64_t> rampDeceleration_{};
+	static inline PerAxis<int64_t> velocity_{};  // Q24
+
+	// Outputs
+	static inline PerAxis<MotorState> motorState_ = detail::filled<AxisCount>(MotorState::Idle);
+	static inline PerAxis<ControlMode> controlMode_ = detail::filled<AxisCount>(ControlMode::None);
+	static inline PerAxis<int32_t> velocityDemand_{};
+
+	static inline modm::PrecisePeriodicTimer updateTimer_{1ms};
+	static inline modm::PreciseClock::time_point lastUpdateTime_{};
+	static modm::PreciseClock::time_point
+	nextUpdate();
+
+	static bool
+	isSupported(OperatingMode mode);
+
+	/// Selects target and rates of the ramp from the state of the axis
+	static void
+	prepareRamp(std::size_t axis);
+	static void
+	prepareStop(std::size_t axis, OptionCode code);
+	static void
+	updateRamps(uint32_t timestep);
+	static void
+	finishRamp(std::size_t axis);
+
+	template<std::size_t Axis, typename ObjectDictionary>
+	static constexpr void
+	registerAxisHandlers(HandlerMap<ObjectDictionary>& map);
+
+	template<std::size_t Axis, auto& Factors, Address Numerator, Address Divisor,
+			 typename ObjectDictionary>
+	static constexpr void
+	registerFactorHandlers(HandlerMap<ObjectDictionary>& map);
+};
+
+}  // namespace modm_canopen::cia402
+
+#include "cia402_multi_axis_impl.hpp"
+#endif
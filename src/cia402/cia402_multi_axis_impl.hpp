@@ -0,0 +1,399 @@
+#ifndef CANOPEN_CIA402_MULTI_AXIS_HPP
+#error "Do not include this file directly, use cia402_multi_axis.hpp instead"
+#endif
+
+namespace modm_canopen::cia402
+{
+
+template<std::size_t AxisCount, std::size_t Instance>
+void
+CiA402MultiAxis<AxisCount, Instance>::setError(std::size_t axis)
+{
+	status_[axis].startFaultReaction();
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+void
+CiA402MultiAxis<AxisCount, Instance>::updateInputs(std::size_t axis, const Inputs& in)
+{
+	actualVelocity_[axis] = in.velocity;
+	actualPosition_[axis] = in.position;
+	actualTorque_[axis] = in.torque;
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+auto
+CiA402MultiAxis<AxisCount, Instance>::getOutputs(std::size_t axis) -> Outputs
+{
+	Outputs outputs{};
+	outputs.state = motorState_[axis];
+	outputs.mode = controlMode_[axis];
+	outputs.demand.velocity = velocityDemand_[axis];
+	return outputs;
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+bool
+CiA402MultiAxis<AxisCount, Instance>::isSupported(OperatingMode mode)
+{
+	// No manufacturer specific (negative) modes are supported
+	const int value = int(mode);
+	return value > 0 && value <= 32 && (supportedModesBitfield_ & (1u << (value - 1)));
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+void
+CiA402MultiAxis<AxisCount, Instance>::prepareStop(std::size_t axis, OptionCode code)
+{
+	stopping_[axis] = true;
+	stopCode_[axis] = code;
+	rampTarget_[axis] = 0;
+	switch (code)
+	{
+		case OptionCode::SlowDownWithRamp:
+		case OptionCode::SlowDownWithRampAndStay:
+			rampAcceleration_[axis] = profileDeceleration_[axis];
+			rampDeceleration_[axis] = profileDeceleration_[axis];
+			rampActive_[axis] = true;
+			break;
+		case OptionCode::SlowDownWithQuickStopRamp:
+		case OptionCode::SlowDownWithQuickStopRampAndStay:
+			rampAcceleration_[axis] = quickStopDeceleration_[axis];
+			rampDeceleration_[axis] = quickStopDeceleration_[axis];
+			rampActive_[axis] = true;
+			break;
+		default:
+			rampActive_[axis] = false;
+			break;
+	}
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+void
+CiA402MultiAxis<AxisCount, Instance>::prepareRamp(std::size_t axis)
+{
+	const bool wasActive = rampActive_[axis];
+	rampActive_[axis] = false;
+	stopping_[axis] = false;
+	switch (status_[axis].state())
+	{
+		case State::OperationEnabled:
+			if (demandedMode_[axis] == OperatingMode::ProfileVelocity)
+			{
+				displayedMode_[axis] = demandedMode_[axis];
+				const auto limit = (int32_t)std::min<uint32_t>(maxProfileVelocity_[axis],
+															   std::numeric_limits<int32_t>::max());
+				rampTarget_[axis] = std::clamp(targetVelocity_[axis], -limit, limit);
+				rampAcceleration_[axis] = profileAcceleration_[axis];
+				rampDeceleration_[axis] = profileDeceleration_[axis];
+				rampActive_[axis] = true;
+			}
+			break;
+		case State::QuickStopActive:
+			prepareStop(axis, quickStopCode_[axis]);
+			break;
+		case State::DisableReactionActive:
+			prepareStop(axis, disableCode_[axis]);
+			break;
+		case State::ShutdownReactionActive:
+			prepareStop(axis, shutdownCode_[axis]);
+			break;
+		case State::HaltReactionActive:
+			prepareStop(axis, haltCode_[axis]);
+			break;
+		case State::FaultReactionActive:
+			prepareStop(axis, faultCode_[axis]);
+			break;
+		default:
+			break;
+	}
+	// Take over from whatever the motor is doing right now
+	if (rampActive_[axis] && !wasActive)
+	{
+		velocity_[axis] = int64_t(actualVelocity_[axis]) << VelocityFractionBits;
+	}
+	if (!rampActive_[axis])
+	{
+		velocity_[axis] = int64_t(actualVelocity_[axis]) << VelocityFractionBits;
+		rampTarget_[axis] = actualVelocity_[axis];
+	}
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+void
+CiA402MultiAxis<AxisCount, Instance>::updateRamps(uint32_t timestep)
+{
+	// Time step in seconds as Q32, so a rate times it is the velocity change in Q24 after >> 8
+	const int64_t timestepQ32 = (int64_t(timestep) << 32) / 1'000'000;
+	for (std::size_t i = 0; i < AxisCount; ++i)
+	{
+		const int64_t velocity = velocity_[i];
+		const int64_t target = int64_t(rampTarget_[i]) << VelocityFractionBits;
+		const bool decelerating = (velocity > 0 && target < velocity) ||
+								  (velocity < 0 && target > velocity);
+		const int64_t rate = decelerating ? rampDeceleration_[i] : rampAcceleration_[i];
+		const int64_t step = (rate == 0) ? NoRampLimit : (rate * timestepQ32) >> 8;
+		velocity_[i] = velocity + std::clamp(target - velocity, -step, step);
+		velocityDemand_[i] = int32_t((velocity_[i] + (int64_t(1) << (VelocityFractionBits - 1))) >>
+									 VelocityFractionBits);
+	}
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+void
+CiA402MultiAxis<AxisCount, Instance>::finishRamp(std::size_t axis)
+{
+	if (stopping_[axis] &&
+		(!rampActive_[axis] || (velocityDemand_[axis] == 0 && actualVelocity_[axis] == 0)))
+	{
+		motorState_[axis] = MotorState::Idle;
+		controlMode_[axis] = ControlMode::None;
+		// "AndStay" codes keep quick stop active, halt ends with the halt bit
+		const auto code = stopCode_[axis];
+		if (status_[axis].state() != State::HaltReactionActive &&
+			(code == OptionCode::DisableDrive || code == OptionCode::SlowDownWithRamp ||
+			 code == OptionCode::SlowDownWithQuickStopRamp))
+		{
+			status_[axis].setReactionDone();
+		}
+		return;
+	}
+	if (!rampActive_[axis])
+	{
+		motorState_[axis] = MotorState::Idle;
+		controlMode_[axis] = ControlMode::None;
+		return;
+	}
+	const bool reaching = std::abs(int64_t(rampTarget_[axis])) >= std::abs(velocityDemand_[axis]);
+	motorState_[axis] = reaching ? MotorState::On : MotorState::Braking;
+	controlMode_[axis] = ControlMode::Velocity;
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+modm::PreciseClock::time_point
+CiA402MultiAxis<AxisCount, Instance>::nextUpdate()
+{
+	return modm::PreciseClock::now() +
+		   std::chrono::duration_cast<modm::PreciseClock::duration>(updateTimer_.remaining());
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+template<typename Device, typename MessageCallback>
+modm::PreciseClock::time_point
+CiA402MultiAxis<AxisCount, Instance>::update(MessageCallback&&)
+{
+	// Only update every x ms
+	if (!updateTimer_.execute()) return nextUpdate();
+
+	const auto now = modm::PreciseClock::now();
+	uint32_t timestep = 0;
+	if (lastUpdateTime_.time_since_epoch().count() != 0)
+	{
+		timestep = std::min<uint32_t>((now - lastUpdateTime_).count(), MaxTimestep);
+	}
+	lastUpdateTime_ = now;
+
+	[]<std::size_t... Axes>(std::index_sequence<Axes...>) {
+		((status_[Axes].wasChanged()
+			  ? Device::setValueChanged(CiA402Objects<uint8_t(Axes)>::StatusWord)
+			  : void()),
+		 ...);
+	}(std::make_index_sequence<AxisCount>{});
+
+	for (std::size_t i = 0; i < AxisCount; ++i) { prepareRamp(i); }
+	updateRamps(timestep);
+	for (std::size_t i = 0; i < AxisCount; ++i) { finishRamp(i); }
+	return nextUpdate();
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+template<typename ObjectDictionary>
+constexpr void
+CiA402MultiAxis<AxisCount, Instance>::registerHandlers(HandlerMap<ObjectDictionary>& map)
+{
+	[&map]<std::size_t... Axes>(std::index_sequence<Axes...>) {
+		(registerAxisHandlers<Axes>(map), ...);
+	}(std::make_index_sequence<AxisCount>{});
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+template<std::size_t Axis, auto& Factors, Address Numerator, Address Divisor,
+		 typename ObjectDictionary>
+constexpr void
+CiA402MultiAxis<AxisCount, Instance>::registerFactorHandlers(HandlerMap<ObjectDictionary>& map)
+{
+	map.template setReadHandler<Numerator>(+[]() { return Factors[Axis].numerator; });
+	map.template setWriteHandler<Numerator>(+[](uint32_t value) {
+		Factors[Axis].numerator = value;
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Divisor>(+[]() { return Factors[Axis].divisor; });
+	map.template setWriteHandler<Divisor>(+[](uint32_t value) {
+		Factors[Axis].divisor = value;
+		return SdoErrorCode::NoError;
+	});
+}
+
+template<std::size_t AxisCount, std::size_t Instance>
+template<std::size_t Axis, typename ObjectDictionary>
+constexpr void
+CiA402MultiAxis<AxisCount, Instance>::registerAxisHandlers(HandlerMap<ObjectDictionary>& map)
+{
+	using Objects = CiA402Objects<uint8_t(Axis)>;
+	using Scaling = ScalingObjects<uint8_t(Axis)>;
+
+	map.template setReadHandler<Objects::ModeOfOperation>(
+		+[]() { return int8_t(demandedMode_[Axis]); });
+	map.template setWriteHandler<Objects::ModeOfOperation>(+[](int8_t value) {
+		if (!isSupported((OperatingMode)value)) return SdoErrorCode::InvalidValue;
+		demandedMode_[Axis] = OperatingMode(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::ModeOfOperationDisplay>(
+		+[]() { return int8_t(displayedMode_[Axis]); });
+
+	map.template setReadHandler<Objects::ControlWord>(
+		+[]() { return status_[Axis].control(); });
+	map.template setWriteHandler<Objects::ControlWord>(+[](uint16_t value) {
+		if (!status_[Axis].update(value)) return SdoErrorCode::InvalidValue;
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::StatusWord>(+[]() { return status_[Axis].status(); });
+
+	map.template setReadHandler<Objects::SupportedDriveModes>(
+		+[]() { return supportedModesBitfield_; });
+
+	map.template setReadHandler<Objects::QuickStopOptionCode>(
+		+[]() { return std::to_underlying(quickStopCode_[Axis]); });
+	map.template setWriteHandler<Objects::QuickStopOptionCode>(+[](int16_t value) {
+		if (!isValidOptionCode((OptionCode)value)) return SdoErrorCode::InvalidValue;
+		quickStopCode_[Axis] = OptionCode(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::ShutdownOptionCode>(
+		+[]() { return std::to_underlying(shutdownCode_[Axis]); });
+	map.template setWriteHandler<Objects::ShutdownOptionCode>(+[](int16_t value) {
+		if (value != (int16_t)OptionCode::DisableDrive &&
+			value != (int16_t)OptionCode::SlowDownWithRamp)
+			return SdoErrorCode::InvalidValue;
+		shutdownCode_[Axis] = OptionCode(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::DisableOperationOptionCode>(
+		+[]() { return std::to_underlying(disableCode_[Axis]); });
+	map.template setWriteHandler<Objects::DisableOperationOptionCode>(+[](int16_t value) {
+		if (value != (int16_t)OptionCode::DisableDrive &&
+			value != (int16_t)OptionCode::SlowDownWithRamp)
+			return SdoErrorCode::InvalidValue;
+		disableCode_[Axis] = OptionCode(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::HaltOptionCode>(
+		+[]() { return std::to_underlying(haltCode_[Axis]); });
+	map.template setWriteHandler<Objects::HaltOptionCode>(+[](int16_t value) {
+		if (value != (int16_t)OptionCode::DisableDrive &&
+			value != (int16_t)OptionCode::SlowDownWithRamp &&
+			value != (int16_t)OptionCode::SlowDownWithQuickStopRamp)
+			return SdoErrorCode::InvalidValue;
+		haltCode_[Axis] = OptionCode(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::FaultReactionOptionCode>(
+		+[]() { return std::to_underlying(faultCode_[Axis]); });
+	map.template setWriteHandler<Objects::FaultReactionOptionCode>(+[](int16_t value) {
+		if (value != (int16_t)OptionCode::DisableDrive &&
+			value != (int16_t)OptionCode::SlowDownWithRamp &&
+			value != (int16_t)OptionCode::SlowDownWithQuickStopRamp)
+			return SdoErrorCode::InvalidValue;
+		faultCode_[Axis] = OptionCode(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::VelocityDemandValue>(+[]() {
+		return velocityFactor1_[Axis].template toUser<int32_t>(velocityDemand_[Axis]);
+	});
+
+	map.template setReadHandler<Objects::TargetVelocity>(+[]() {
+		return velocityFactor1_[Axis].template toUser<int32_t>(targetVelocity_[Axis]);
+	});
+	map.template setWriteHandler<Objects::TargetVelocity>(+[](int32_t value) {
+		targetVelocity_[Axis] = velocityFactor1_[Axis].template toInternal<int32_t>(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::MaxProfileVelocity>(+[]() {
+		return velocityFactor1_[Axis].template toUser<uint32_t>(maxProfileVelocity_[Axis]);
+	});
+	map.template setWriteHandler<Objects::MaxProfileVelocity>(+[](uint32_t value) {
+		maxProfileVelocity_[Axis] = velocityFactor1_[Axis].template toInternal<uint32_t>(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::ProfileAcceleration>(+[]() {
+		return accelerationFactor_[Axis].template toUser<uint32_t>(profileAcceleration_[Axis]);
+	});
+	map.template setWriteHandler<Objects::ProfileAcceleration>(+[](uint32_t value) {
+		profileAcceleration_[Axis] = accelerationFactor_[Axis].template toInternal<uint32_t>(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::ProfileDeceleration>(+[]() {
+		return accelerationFactor_[Axis].template toUser<uint32_t>(profileDeceleration_[Axis]);
+	});
+	map.template setWriteHandler<Objects::ProfileDeceleration>(+[](uint32_t value) {
+		profileDeceleration_[Axis] = accelerationFactor_[Axis].template toInternal<uint32_t>(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::QuickStopDeceleration>(+[]() {
+		return accelerationFactor_[Axis].template toUser<uint32_t>(quickStopDeceleration_[Axis]);
+	});
+	map.template setWriteHandler<Objects::QuickStopDeceleration>(+[](uint32_t value) {
+		quickStopDeceleration_[Axis] =
+			accelerationFactor_[Axis].template toInternal<uint32_t>(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<Objects::MotionProfileType>(
+		+[]() { return std::to_underlying(ProfileType::LinearRamp); });
+	map.template setWriteHandler<Objects::MotionProfileType>(+[](int16_t value) {
+		if (value != (int16_t)ProfileType::LinearRamp) return SdoErrorCode::InvalidValue;
+		return SdoErrorCode::NoError;
+	});
+
+	registerFactorHandlers<Axis, positionEncoderResolution_,
+						   Scaling::PositionEncoderResolutionNumerator,
+						   Scaling::PositionEncoderResolutionDivisor>(map);
+	registerFactorHandlers<Axis, velocityEncoderResolution_,
+						   Scaling::VelocityEncoderResolutionNumerator,
+						   Scaling::VelocityEncoderResolutionDivisor>(map);
+	registerFactorHandlers<Axis, gearRatio_, Scaling::GearRatioNumerator,
+						   Scaling::GearRatioDivisor>(map);
+	registerFactorHandlers<Axis, feed_, Scaling::FeedNumerator, Scaling::FeedDivisor>(map);
+	registerFactorHandlers<Axis, positionFactor_, Scaling::PositionFactorNumerator,
+						   Scaling::PositionFactorDivisor>(map);
+	registerFactorHandlers<Axis, velocityEncoderFactor_, Scaling::VelocityEncoderFactorNumerator,
+						   Scaling::VelocityEncoderFactorDivisor>(map);
+	registerFactorHandlers<Axis, velocityFactor1_, Scaling::VelocityFactor1Numerator,
+						   Scaling::VelocityFactor1Divisor>(map);
+	registerFactorHandlers<Axis, velocityFactor2_, Scaling::VelocityFactor2Numerator,
+						   Scaling::VelocityFactor2Divisor>(map);
+	registerFactorHandlers<Axis, accelerationFactor_, Scaling::AccelerationFactorNumerator,
+						   Scaling::AccelerationFactorDivisor>(map);
+
+	// Position (bit 7) and velocity (bit 6) polarity, not applied by this protocol
+	map.template setReadHandler<Scaling::Polarity>(+[]() { return polarity_[Axis]; });
+	map.template setWriteHandler<Scaling::Polarity>(+[](uint8_t value) {
+		polarity_[Axis] = value & ((1 << 7) | (1 << 6));
+		return SdoErrorCode::NoError;
+	});
+}
+
+}  // namespace modm_canopen::cia402
@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include "../object_dictionary_common.hpp"
 namespace modm_canopen::cia402
 {
@@ -16,5 +18,46 @@ struct CiA402Objects
 	static constexpr modm_canopen::Address DisableOperationOptionCode{0x605C + 0x800 * Axis, 0};
 	static constexpr modm_canopen::Address HaltOptionCode{0x605D + 0x800 * Axis, 0};
 	static constexpr modm_canopen::Address FaultReactionOptionCode{0x605E + 0x800 * Axis, 0};
+
+	static constexpr modm_canopen::Address VelocityDemandValue{0x606B + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address TargetVelocity{0x60FF + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address MaxProfileVelocity{0x607F + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address ProfileAcceleration{0x6083 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address ProfileDeceleration{0x6084 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address QuickStopDeceleration{0x6085 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address MotionProfileType{0x6086 + 0x800 * Axis, 0};
+
+	static constexpr modm_canopen::Address PositionActualValue{0x6064 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address VelocityActualValue{0x606C + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address TorqueActualValue{0x6077 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address TargetPosition{0x607A + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address TargetTorque{0x6071 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address VelocityOffset{0x60B1 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address TorqueOffset{0x60B2 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address InterpolationSubModeSelect{0x60C0 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address InterpolationDataRecordCount{0x60C1 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address InterpolationDataRecord{0x60C1 + 0x800 * Axis, 1};
+	static constexpr modm_canopen::Address InterpolationTimePeriodCount{0x60C2 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address InterpolationTimePeriodValue{0x60C2 + 0x800 * Axis, 1};
+	static constexpr modm_canopen::Address InterpolationTimeIndex{0x60C2 + 0x800 * Axis, 2};
+	static constexpr modm_canopen::Address InterpolationBufferCount{0x60C4 + 0x800 * Axis, 0};
+	static constexpr modm_canopen::Address MaximumBufferSize{0x60C4 + 0x800 * Axis, 1};
+	static constexpr modm_canopen::Address ActualBufferSize{0x60C4 + 0x800 * Axis, 2};
+	static constexpr modm_canopen::Address BufferOrganization{0x60C4 + 0x800 * Axis, 3};
+	static constexpr modm_canopen::Address BufferPosition{0x60C4 + 0x800 * Axis, 4};
+	static constexpr modm_canopen::Address SizeOfDataRecord{0x60C4 + 0x800 * Axis, 5};
+	static constexpr modm_canopen::Address BufferClear{0x60C4 + 0x800 * Axis, 6};
+
+	/// Commands and setpoints, a restored value must not move the drive after a reset
+	static constexpr std::array ProcessData{ControlWord,    ModeOfOperation, TargetPosition,
+											TargetVelocity, TargetTorque,    VelocityOffset,
+											TorqueOffset,   InterpolationDataRecord,
+											BufferClear};
+
+	static constexpr bool
+	isProcessData(modm_canopen::Address address)
+	{
+		return std::ranges::find(ProcessData, address) != ProcessData.end();
+	}
 };
 }  // namespace modm_canopen::cia402
\ No newline at end of file
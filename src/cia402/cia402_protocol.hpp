@@ -3,38 +3,40 @@
 #include <modm/architecture/interface/can_message.hpp>
 #include <modm/processing/timer.hpp>
 #include "../device/handler_map.hpp"
+#include "../device/sync_scheduler.hpp"
+#include "../nmt_state.hpp"
+#include "axis_io.hpp"
 #include "cia402_objects.hpp"
 #include "operating_mode.hpp"
 #include "state_machine.hpp"
 #include "option_code.hpp"
 #include "profile_type.hpp"
+#include "velocity_ramp.hpp"
+#include "setpoint_interpolator.hpp"
+#include "setpoint_buffer.hpp"
 #include "factors.hpp"
 #include "../sdo_error.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <limits>
 
 namespace modm_canopen::cia402
 {
-template<uint8_t Axis>
+/// All state is static, Instance tells the devices of a CanopenDeviceGroup apart
+template<uint8_t Axis, std::size_t Instance = 0>
 class CiA402
 {
 	static_assert(Axis < 8, "Only 8 axes per device are supported by the CiA402 standard");
 
 public:
-	enum class MotorState
-	{
-		On,
-		Idle,
-		Braking
-	};
+	template<std::size_t I>
+	using ForInstance = CiA402<Axis, I>;
 
-	enum class ControlMode
-	{
-		Velocity,
-		Voltage,
-		Torque,
-		Position,
-		None,
-	};
+	using MotorState = cia402::MotorState;
+	using ControlMode = cia402::ControlMode;
 
 	struct PidValues
 	{
@@ -45,25 +47,8 @@ public:
 		float max{0.0f};
 	};
 
-	struct Inputs
-	{
-		int32_t current[3];  // ma
-		int32_t torque;      // ticks/s^2? TBD
-		int32_t velocity;    // ticks/s
-		int32_t position;    // ticks
-	};
-
-	struct Outputs
-	{
-		MotorState state;
-		ControlMode mode;
-		union {
-			int32_t torque;    // ticks/s^2
-			int32_t velocity;  // ticks/s
-			int32_t position;  // ticks
-		} demand;
-		uint16_t currentLimit;  // ma
-	};
+	using Inputs = AxisInputs;
+	using Outputs = AxisOutputs;
 
 	struct ControlValues
 	{
@@ -104,17 +89,66 @@ private:
 	static inline uint16_t velocityThresholdTime_{0};
 	static inline int32_t targetVelocity_{0};
 	static inline int32_t maxSlippage_{0};
-	static inline uint32_t maxProfileVelocity_{0};
+	static inline uint32_t maxProfileVelocity_{std::numeric_limits<uint32_t>::max()};
 	static inline uint32_t maxMotorSpeed_{0};
 	static inline uint32_t maxAcceleration_{0};
 	static inline uint32_t profileAcceleration_{0};
+	static inline uint32_t profileDeceleration_{0};
 	static inline uint32_t quickStopDeceleration_{0};
 	static inline ProfileType motionProfile_{ProfileType::LinearRamp};
+	static inline VelocityRamp velocityRamp_{};
 
+	/// Ramps the velocity demand towards target by one time step
 	static void
 	profileVelocityUpdate(uint32_t deceleration, uint32_t acceleration, int32_t target);
 
-	static constexpr uint32_t supportedModesBitfield_ = 0b1110'0000'0000'0000'0000'0001'1000'0010;
+	static inline int32_t targetPosition_{0};
+	static inline int32_t velocityOffset_{0};
+	static inline int16_t torqueOffset_{0};  // [-1000,1000]*motorRatedTorque_/1000
+	static inline InterpolationType interpolationType_{InterpolationType::Linear};
+	static inline SetpointInterpolator positionSetpoints_{};
+	static inline SetpointInterpolator velocitySetpoints_{};
+	static inline SetpointInterpolator torqueSetpoints_{};
+
+	static bool
+	isCyclicMode(OperatingMode mode);
+	/// Holds the actual values until the first setpoints arrive
+	static void
+	startCyclic(modm::PreciseClock::time_point now);
+	/// Interpolates the setpoints of the cyclic synchronous modes against the SYNC period
+	template<typename Device>
+	static void
+	cyclicUpdate(modm::PreciseClock::time_point now);
+
+	static constexpr std::size_t InterpolationBufferCapacity = 16;
+	// Filled by 0x60C1 writes from CAN reception, emptied by update()
+	static inline SetpointBuffer<int32_t, InterpolationBufferCapacity> interpolationBuffer_{};
+	static inline uint32_t interpolationBufferSize_{InterpolationBufferCapacity};  // 0x60C4.2
+	static inline bool interpolationBufferEnabled_{true};                        // 0x60C4.6
+	static inline std::atomic<bool> interpolationOverflow_{false};
+	static inline int32_t interpolationRecord_{0};
+	static inline uint8_t interpolationPeriodValue_{1};  // 0x60C2.1, 0 uses the SYNC period
+	static inline int8_t interpolationTimeIndex_{-3};    // 0x60C2.2, period in 10^index s
+	static inline bool interpolating_{false};
+	static inline bool interpolationUnderflow_{false};
+	static inline modm::PreciseClock::time_point recordStart_{};
+	// Only fed from interpolationBuffer_, 0x607A writes go to positionSetpoints_
+	static inline SetpointInterpolator interpolatedSetpoints_{};
+
+	/// Interpolation time period (0x60C2) in us
+	template<typename Device>
+	static uint32_t
+	interpolationPeriod();
+	/// Takes the next record from the buffer whenever one interpolation time period has passed
+	template<typename Device>
+	static void
+	interpolatedPositionUpdate(modm::PreciseClock::time_point now);
+
+	template<typename Device, StatusBits Bit>
+	static void
+	setStatusBit(bool value);
+
+	static constexpr uint32_t supportedModesBitfield_ = 0b1110'0000'0000'0000'0000'0011'1100'0110;
 	static inline bool
 	isSupported(OperatingMode mode);
 
@@ -122,6 +156,18 @@ private:
 	static inline modm::PreciseClock::duration lastTimestep_{};
 	static inline uint32_t lastTimeStepRough_{};  // 10^-1ms
 	static inline modm::PrecisePeriodicTimer updateTimer_{1ms};
+	static modm::PreciseClock::time_point
+	nextUpdate();
+	// While the SYNC is active the control step is a SyncScheduler task instead of the timer
+	static inline bool syncScheduled_{false};
+	/// State machine and operating mode, runs every 1 ms or once per SYNC
+	template<typename Device>
+	static void
+	controlStep();
+	/// Only operational devices run the control step, like update()
+	template<typename Device>
+	static void
+	syncControlStep();
 	static inline Inputs inputs_{};
 	static inline Outputs outputs_{};
 
@@ -144,8 +190,20 @@ public:
 	getControlValues();
 
 	// Canopen Protocol
+	/// Objects ParameterStorage must not restore
+	static constexpr bool
+	isProcessData(Address address)
+	{
+		return CiA402Objects<Axis>::isProcessData(address);
+	}
+
+	/// The control step runs this long before each SYNC while it is active, so the synchronous
+	/// TPDOs carry its results
+	static constexpr std::chrono::microseconds SyncOffset{-200};
+
+	/// Returns when the next control step is due
 	template<typename Device, typename MessageCallback>
-	static void
+	static modm::PreciseClock::time_point
 	update(MessageCallback&&);
 
 	template<typename Device, typename MessageCallback>
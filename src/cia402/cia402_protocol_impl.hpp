@@ -5,16 +5,30 @@
 namespace modm_canopen::cia402
 {
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance>
 void
-CiA402<Axis>::setError()
+CiA402<Axis, Instance>::setError()
 {
 	status_.startFaultReaction();
 }
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance>
+void
+CiA402<Axis, Instance>::updateInputs(const Inputs &in)
+{
+	inputs_ = in;
+}
+
+template<uint8_t Axis, std::size_t Instance>
+auto
+CiA402<Axis, Instance>::getOutputs() -> const Outputs &
+{
+	return outputs_;
+}
+
+template<uint8_t Axis, std::size_t Instance>
 bool
-CiA402<Axis>::isSupported(OperatingMode mode)
+CiA402<Axis, Instance>::isSupported(OperatingMode mode)
 {
 	if ((int)mode >= 0)
 		return supportedModesBitfield_ & (1 << (((int)mode) - 1));
@@ -22,17 +36,158 @@ CiA402<Axis>::isSupported(OperatingMode mode)
 		return supportedModesBitfield_ & (1 << (32 - (int)mode));
 }
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance>
+bool
+CiA402<Axis, Instance>::isCyclicMode(OperatingMode mode)
+{
+	return mode == OperatingMode::CyclicSynchronousPosition ||
+		   mode == OperatingMode::CyclicSynchronousVelocity ||
+		   mode == OperatingMode::CyclicSynchronousTorque;
+}
+
+template<uint8_t Axis, std::size_t Instance>
 void
-CiA402<Axis>::profileVelocityUpdate(uint32_t deceleration, uint32_t acceleration, int32_t target)
+CiA402<Axis, Instance>::startCyclic(modm::PreciseClock::time_point now)
 {
-	// TODO
+	positionSetpoints_.reset(inputs_.position, now);
+	velocitySetpoints_.reset(inputs_.velocity, now);
+	torqueSetpoints_.reset(inputs_.torque, now);
 }
 
+template<uint8_t Axis, std::size_t Instance>
+template<typename Device>
+void
+CiA402<Axis, Instance>::cyclicUpdate(modm::PreciseClock::time_point now)
+{
+	// Without SYNC the interval between the setpoints is the best guess
+	const auto& pll = Device::syncPll();
+	const auto periodOf = [&pll](const SetpointInterpolator& setpoints) -> uint32_t {
+		if (pll.isStarted()) return pll.period().count() / 1000;
+		return setpoints.interval();
+	};
+	const auto saturate = [](int64_t value) {
+		return (int32_t)std::clamp<int64_t>(value, std::numeric_limits<int32_t>::min(),
+											std::numeric_limits<int32_t>::max());
+	};
 
-template<uint8_t Axis>
+	switch (displayedMode_)
+	{
+		case OperatingMode::CyclicSynchronousPosition:
+			outputs_.mode = ControlMode::Position;
+			outputs_.demand.position = positionSetpoints_.evaluate(
+				now, periodOf(positionSetpoints_), interpolationType_);
+			outputs_.feedForward.velocity = velocityOffset_;
+			outputs_.feedForward.torque = torqueOffset_;
+			break;
+		case OperatingMode::CyclicSynchronousVelocity:
+			velocityDemand_ = saturate(int64_t(velocitySetpoints_.evaluate(
+										   now, periodOf(velocitySetpoints_), interpolationType_)) +
+									   velocityOffset_);
+			outputs_.mode = ControlMode::Velocity;
+			outputs_.demand.velocity = velocityDemand_;
+			outputs_.feedForward.torque = torqueOffset_;
+			break;
+		case OperatingMode::CyclicSynchronousTorque:
+			outputs_.mode = ControlMode::Torque;
+			outputs_.demand.torque = saturate(
+				int64_t(torqueSetpoints_.evaluate(now, periodOf(torqueSetpoints_),
+												  interpolationType_)) +
+				torqueOffset_);
+			break;
+		default:
+			return;
+	}
+	outputs_.state = MotorState::On;
+	// Stop reactions ramp down from the actual velocity
+	velocityRamp_.reset(inputs_.velocity);
+}
+
+template<uint8_t Axis, std::size_t Instance>
+template<typename Device>
+uint32_t
+CiA402<Axis, Instance>::interpolationPeriod()
+{
+	if (interpolationPeriodValue_ == 0)
+	{
+		const auto& pll = Device::syncPll();
+		return pll.isStarted() ? pll.period().count() / 1000 : 0;
+	}
+	uint32_t period = interpolationPeriodValue_;
+	for (int8_t index = -6; index < interpolationTimeIndex_; ++index) { period *= 10; }
+	return period;
+}
+
+template<uint8_t Axis, std::size_t Instance>
+template<typename Device>
 void
-CiA402<Axis>::handleOptionCode(const OptionCode &code)
+CiA402<Axis, Instance>::interpolatedPositionUpdate(modm::PreciseClock::time_point now)
+{
+	const uint32_t period = interpolationPeriod<Device>();
+	const modm::PreciseClock::duration periodDuration{period};
+	const bool enabled =
+		status_.isSetControl<CommandBits::EnableInterpolation>() && period != 0;
+	// The first record is taken right away
+	if (enabled && !interpolating_)
+	{
+		recordStart_ = now - periodDuration;
+		interpolationUnderflow_ = false;
+	}
+	interpolating_ = enabled;
+
+	interpolationBuffer_.discardCleared();
+	using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+	while (enabled && SignedRep((now - recordStart_).count()) >= SignedRep(period))
+	{
+		const auto record = interpolationBuffer_.pop();
+		if (!record)
+		{
+			interpolationUnderflow_ = true;
+			break;
+		}
+		// After an underflow the record starts now instead of where the last one ended
+		recordStart_ = interpolationUnderflow_ ? now : recordStart_ + periodDuration;
+		interpolationUnderflow_ = false;
+		interpolatedSetpoints_.push(*record, recordStart_);
+	}
+
+	outputs_.state = MotorState::On;
+	outputs_.mode = ControlMode::Position;
+	outputs_.demand.position = interpolatedSetpoints_.evaluate(now, period, interpolationType_);
+	// Stop reactions ramp down from the actual velocity
+	velocityRamp_.reset(inputs_.velocity);
+}
+
+template<uint8_t Axis, std::size_t Instance>
+template<typename Device, StatusBits Bit>
+void
+CiA402<Axis, Instance>::setStatusBit(bool value)
+{
+	if (status_.isSet<Bit>() == value) return;
+	status_.setBit<Bit>(value);
+	Device::setValueChanged(CiA402Objects<Axis>::StatusWord);
+}
+
+template<uint8_t Axis, std::size_t Instance>
+void
+CiA402<Axis, Instance>::profileVelocityUpdate(uint32_t deceleration, uint32_t acceleration,
+											  int32_t target)
+{
+	// Take over from whatever the motor is doing right now
+	if (outputs_.mode != ControlMode::Velocity) { velocityRamp_.reset(inputs_.velocity); }
+	velocityRamp_.setTarget(target, acceleration, deceleration, motionProfile_);
+	velocityDemand_ = velocityRamp_.update(lastTimestep_.count());
+
+	outputs_.state = (velocityRamp_.isDone() || std::abs(target) >= std::abs(velocityDemand_))
+						 ? MotorState::On
+						 : MotorState::Braking;
+	outputs_.mode = ControlMode::Velocity;
+	outputs_.demand.velocity = velocityDemand_;
+}
+
+
+template<uint8_t Axis, std::size_t Instance>
+void
+CiA402<Axis, Instance>::handleOptionCode(const OptionCode &code)
 {
 	switch (code)
 	{
@@ -42,7 +197,7 @@ CiA402<Axis>::handleOptionCode(const OptionCode &code)
 			status_.setReactionDone();
 			break;
 		case OptionCode::SlowDownWithQuickStopRamp:
-			if (inputs_.velocity != 0)
+			if (inputs_.velocity != 0 || velocityDemand_ != 0)
 			{
 				profileVelocityUpdate(quickStopDeceleration_, quickStopDeceleration_, 0);
 			} else
@@ -53,7 +208,7 @@ CiA402<Axis>::handleOptionCode(const OptionCode &code)
 			}
 			break;
 		case OptionCode::SlowDownWithQuickStopRampAndStay:
-			if (inputs_.velocity != 0)
+			if (inputs_.velocity != 0 || velocityDemand_ != 0)
 			{
 				profileVelocityUpdate(quickStopDeceleration_, quickStopDeceleration_, 0);
 			} else
@@ -63,24 +218,24 @@ CiA402<Axis>::handleOptionCode(const OptionCode &code)
 			}
 			break;
 		case OptionCode::SlowDownWithRamp:
-			if (inputs_.velocity != 0)
+			if (inputs_.velocity != 0 || velocityDemand_ != 0)
 			{
-				profileVelocityUpdate(quickStopDeceleration_, quickStopDeceleration_, 0);
+				profileVelocityUpdate(profileDeceleration_, profileDeceleration_, 0);
 			} else
 			{
 				outputs_.state = MotorState::Idle;
 				outputs_.mode = ControlMode::None;
+				status_.setReactionDone();
 			}
 			break;
 		case OptionCode::SlowDownWithRampAndStay:
-			if (inputs_.velocity != 0)
+			if (inputs_.velocity != 0 || velocityDemand_ != 0)
 			{
-				profileVelocityUpdate(quickStopDeceleration_, quickStopDeceleration_, 0);
+				profileVelocityUpdate(profileDeceleration_, profileDeceleration_, 0);
 			} else
 			{
 				outputs_.state = MotorState::Idle;
 				outputs_.mode = ControlMode::None;
-				status_.setReactionDone();
 			}
 			break;
 		default:
@@ -88,14 +243,52 @@ CiA402<Axis>::handleOptionCode(const OptionCode &code)
 	}
 }
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance>
+modm::PreciseClock::time_point
+CiA402<Axis, Instance>::nextUpdate()
+{
+	return modm::PreciseClock::now() +
+		   std::chrono::duration_cast<modm::PreciseClock::duration>(updateTimer_.remaining());
+}
+
+template<uint8_t Axis, std::size_t Instance>
 template<typename Device, typename MessageCallback>
-void
-CiA402<Axis>::update(MessageCallback &&)
+modm::PreciseClock::time_point
+CiA402<Axis, Instance>::update(MessageCallback &&)
 {
+	using Scheduler = SyncScheduler<Device>;
+	const bool syncActive = Scheduler::isActive();
+	if (syncActive && !syncScheduled_)
+	{
+		// Stays on the timer if all task slots are taken
+		syncScheduled_ = Scheduler::addTask(&syncControlStep<Device>, SyncOffset);
+	} else if (!syncActive && syncScheduled_)
+	{
+		Scheduler::removeTask(&syncControlStep<Device>);
+		syncScheduled_ = false;
+	}
+	// The scheduler adds the deadline of the task
+	if (syncScheduled_) return modm::PreciseClock::now() + Device::MaxUpdateInterval;
+
 	// Only update every x ms
-	if (!updateTimer_.execute()) return;
+	if (!updateTimer_.execute()) return nextUpdate();
+	controlStep<Device>();
+	return nextUpdate();
+}
+
+template<uint8_t Axis, std::size_t Instance>
+template<typename Device>
+void
+CiA402<Axis, Instance>::syncControlStep()
+{
+	if (Device::nmtState() == NMTState::Operational) { controlStep<Device>(); }
+}
 
+template<uint8_t Axis, std::size_t Instance>
+template<typename Device>
+void
+CiA402<Axis, Instance>::controlStep()
+{
 	const auto now = modm::PreciseClock::now();
 	if (lastUpdateTime_.time_since_epoch().count() != 0)
 	{
@@ -105,6 +298,7 @@ CiA402<Axis>::update(MessageCallback &&)
 	}
 
 	lastUpdateTime_ = now;
+	outputs_.feedForward = {};
 
 	if (status_.wasChanged())
 	{
@@ -119,6 +313,33 @@ CiA402<Axis>::update(MessageCallback &&)
 			break;
 		case State::OperationEnabled:
 			// Do OperatingMode update
+			if (demandedMode_ == OperatingMode::ProfileVelocity)
+			{
+				displayedMode_ = demandedMode_;
+				const auto limit = (int32_t)std::min<uint32_t>(
+					maxProfileVelocity_, std::numeric_limits<int32_t>::max());
+				profileVelocityUpdate(profileDeceleration_, profileAcceleration_,
+									  std::clamp(targetVelocity_, -limit, limit));
+			} else if (isCyclicMode(demandedMode_))
+			{
+				if (displayedMode_ != demandedMode_ ||
+					lastProcessedState_ != State::OperationEnabled)
+				{
+					startCyclic(now);
+				}
+				displayedMode_ = demandedMode_;
+				cyclicUpdate<Device>(now);
+			} else if (demandedMode_ == OperatingMode::InterpolatedPosition)
+			{
+				if (displayedMode_ != demandedMode_ ||
+					lastProcessedState_ != State::OperationEnabled)
+				{
+					interpolatedSetpoints_.reset(inputs_.position, now);
+					interpolating_ = false;
+				}
+				displayedMode_ = demandedMode_;
+				interpolatedPositionUpdate<Device>(now);
+			}
 			break;
 		case State::DisableReactionActive:
 			// Slow down depending on disable operation code
@@ -141,20 +362,31 @@ CiA402<Axis>::update(MessageCallback &&)
 		default:
 			break;
 	}
+	lastProcessedState_ = status_.state();
+
+	// Bit 12: the targets are followed in the cyclic synchronous modes, interpolation is active
+	// in interpolated position mode
+	const bool operating = (status_.state() == State::OperationEnabled);
+	const bool interpolated = (displayedMode_ == OperatingMode::InterpolatedPosition);
+	setStatusBit<Device, StatusBits::TargetIgnored>(
+		operating && (isCyclicMode(displayedMode_) || (interpolated && interpolating_)));
+	setStatusBit<Device, StatusBits::BufferUnderflow>(operating && interpolated &&
+													  interpolating_ && interpolationUnderflow_);
+	setStatusBit<Device, StatusBits::BufferOverflow>(interpolated && interpolationOverflow_);
 }
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance>
 template<typename Device, typename MessageCallback>
 void
-CiA402<Axis>::processMessage(const modm::can::Message &, MessageCallback &&)
+CiA402<Axis, Instance>::processMessage(const modm::can::Message &, MessageCallback &&)
 {}
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance>
 template<typename ObjectDictionary>
 constexpr void
-CiA402<Axis>::registerHandlers(HandlerMap<ObjectDictionary> &map)
+CiA402<Axis, Instance>::registerHandlers(HandlerMap<ObjectDictionary> &map)
 {
-	CiA402Factors<Axis>::registerHandlers(map);
+	CiA402Factors<Axis, Instance>::registerHandlers(map);
 
 	map.template setReadHandler<CiA402Objects<Axis>::ModeOfOperation>(
 		+[]() { return int8_t(demandedMode_); });
@@ -234,6 +466,181 @@ CiA402<Axis>::registerHandlers(HandlerMap<ObjectDictionary> &map)
 		return SdoErrorCode::NoError;
 	});
 
+	using Factors = CiA402Factors<Axis, Instance>;
+	map.template setReadHandler<CiA402Objects<Axis>::VelocityDemandValue>(
+		+[]() { return Factors::velocity1.template toUser<int32_t>(velocityDemand_); });
+
+	map.template setReadHandler<CiA402Objects<Axis>::TargetVelocity>(
+		+[]() { return Factors::velocity1.template toUser<int32_t>(targetVelocity_); });
+	map.template setWriteHandler<CiA402Objects<Axis>::TargetVelocity>(+[](int32_t value) {
+		targetVelocity_ = Factors::velocity1.template toInternal<int32_t>(value);
+		velocitySetpoints_.push(targetVelocity_, modm::PreciseClock::now());
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::MaxProfileVelocity>(
+		+[]() { return Factors::velocity1.template toUser<uint32_t>(maxProfileVelocity_); });
+	map.template setWriteHandler<CiA402Objects<Axis>::MaxProfileVelocity>(+[](uint32_t value) {
+		maxProfileVelocity_ = Factors::velocity1.template toInternal<uint32_t>(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::ProfileAcceleration>(
+		+[]() { return Factors::acceleration.template toUser<uint32_t>(profileAcceleration_); });
+	map.template setWriteHandler<CiA402Objects<Axis>::ProfileAcceleration>(+[](uint32_t value) {
+		profileAcceleration_ = Factors::acceleration.template toInternal<uint32_t>(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::ProfileDeceleration>(
+		+[]() { return Factors::acceleration.template toUser<uint32_t>(profileDeceleration_); });
+	map.template setWriteHandler<CiA402Objects<Axis>::ProfileDeceleration>(+[](uint32_t value) {
+		profileDeceleration_ = Factors::acceleration.template toInternal<uint32_t>(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::QuickStopDeceleration>(
+		+[]() { return Factors::acceleration.template toUser<uint32_t>(quickStopDeceleration_); });
+	map.template setWriteHandler<CiA402Objects<Axis>::QuickStopDeceleration>(+[](uint32_t value) {
+		quickStopDeceleration_ = Factors::acceleration.template toInternal<uint32_t>(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::MotionProfileType>(
+		+[]() { return std::to_underlying(motionProfile_); });
+	map.template setWriteHandler<CiA402Objects<Axis>::MotionProfileType>(+[](int16_t value) {
+		if (value != (int16_t)ProfileType::LinearRamp && value != (int16_t)ProfileType::Sin2Ramp)
+			return SdoErrorCode::InvalidValue;
+		motionProfile_ = ProfileType(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::PositionActualValue>(
+		+[]() { return Factors::position.template toUser<int32_t>(inputs_.position); });
+
+	map.template setReadHandler<CiA402Objects<Axis>::VelocityActualValue>(
+		+[]() { return Factors::velocity1.template toUser<int32_t>(inputs_.velocity); });
+
+	map.template setReadHandler<CiA402Objects<Axis>::TorqueActualValue>(+[]() {
+		return (int16_t)std::clamp<int32_t>(inputs_.torque, std::numeric_limits<int16_t>::min(),
+											std::numeric_limits<int16_t>::max());
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::TargetPosition>(
+		+[]() { return Factors::position.template toUser<int32_t>(targetPosition_); });
+	map.template setWriteHandler<CiA402Objects<Axis>::TargetPosition>(+[](int32_t value) {
+		targetPosition_ = Factors::position.template toInternal<int32_t>(value);
+		positionSetpoints_.push(targetPosition_, modm::PreciseClock::now());
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::TargetTorque>(
+		+[]() { return targetTorqueRatio_; });
+	map.template setWriteHandler<CiA402Objects<Axis>::TargetTorque>(+[](int16_t value) {
+		targetTorqueRatio_ = value;
+		torqueSetpoints_.push(targetTorqueRatio_, modm::PreciseClock::now());
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::VelocityOffset>(
+		+[]() { return Factors::velocity1.template toUser<int32_t>(velocityOffset_); });
+	map.template setWriteHandler<CiA402Objects<Axis>::VelocityOffset>(+[](int32_t value) {
+		velocityOffset_ = Factors::velocity1.template toInternal<int32_t>(value);
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::TorqueOffset>(
+		+[]() { return torqueOffset_; });
+	map.template setWriteHandler<CiA402Objects<Axis>::TorqueOffset>(+[](int16_t value) {
+		torqueOffset_ = value;
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::InterpolationSubModeSelect>(
+		+[]() { return std::to_underlying(interpolationType_); });
+	map.template setWriteHandler<CiA402Objects<Axis>::InterpolationSubModeSelect>(
+		+[](int16_t value) {
+			if (value != (int16_t)InterpolationType::Linear &&
+				value != (int16_t)InterpolationType::Cubic)
+				return SdoErrorCode::InvalidValue;
+			interpolationType_ = InterpolationType(value);
+			return SdoErrorCode::NoError;
+		});
+
+	map.template setReadHandler<CiA402Objects<Axis>::InterpolationDataRecordCount>(
+		+[]() { return uint8_t(1); });
+	map.template setReadHandler<CiA402Objects<Axis>::InterpolationDataRecord>(
+		+[]() { return Factors::position.template toUser<int32_t>(interpolationRecord_); });
+	map.template setWriteHandler<CiA402Objects<Axis>::InterpolationDataRecord>(+[](int32_t value) {
+		if (!interpolationBufferEnabled_) return SdoErrorCode::DataCannotBeTransferred;
+		interpolationRecord_ = Factors::position.template toInternal<int32_t>(value);
+		if (!interpolationBuffer_.push(interpolationRecord_, interpolationBufferSize_))
+		{
+			interpolationOverflow_ = true;
+			return SdoErrorCode::ResourceUnavailable;
+		}
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::InterpolationTimePeriodCount>(
+		+[]() { return uint8_t(2); });
+	map.template setReadHandler<CiA402Objects<Axis>::InterpolationTimePeriodValue>(
+		+[]() { return interpolationPeriodValue_; });
+	map.template setWriteHandler<CiA402Objects<Axis>::InterpolationTimePeriodValue>(
+		+[](uint8_t value) {
+			interpolationPeriodValue_ = value;
+			return SdoErrorCode::NoError;
+		});
+	map.template setReadHandler<CiA402Objects<Axis>::InterpolationTimeIndex>(
+		+[]() { return interpolationTimeIndex_; });
+	map.template setWriteHandler<CiA402Objects<Axis>::InterpolationTimeIndex>(+[](int8_t value) {
+		if (value < -6) return SdoErrorCode::ValueOfParameterTooLow;
+		if (value > 0) return SdoErrorCode::ValueOfParameterTooHigh;
+		interpolationTimeIndex_ = value;
+		return SdoErrorCode::NoError;
+	});
+
+	map.template setReadHandler<CiA402Objects<Axis>::InterpolationBufferCount>(
+		+[]() { return uint8_t(6); });
+	map.template setReadHandler<CiA402Objects<Axis>::MaximumBufferSize>(
+		+[]() { return uint32_t(InterpolationBufferCapacity); });
+	map.template setReadHandler<CiA402Objects<Axis>::ActualBufferSize>(
+		+[]() { return interpolationBufferSize_; });
+	map.template setWriteHandler<CiA402Objects<Axis>::ActualBufferSize>(+[](uint32_t value) {
+		if (value == 0) return SdoErrorCode::ValueOfParameterTooLow;
+		if (value > InterpolationBufferCapacity) return SdoErrorCode::ValueOfParameterTooHigh;
+		interpolationBufferSize_ = value;
+		return SdoErrorCode::NoError;
+	});
+	// FIFO only, records are always appended
+	map.template setReadHandler<CiA402Objects<Axis>::BufferOrganization>(
+		+[]() { return uint8_t(0); });
+	map.template setWriteHandler<CiA402Objects<Axis>::BufferOrganization>(+[](uint8_t value) {
+		if (value != 0) return SdoErrorCode::InvalidValue;
+		return SdoErrorCode::NoError;
+	});
+	map.template setReadHandler<CiA402Objects<Axis>::BufferPosition>(
+		+[]() { return uint16_t(0); });
+	map.template setWriteHandler<CiA402Objects<Axis>::BufferPosition>(+[](uint16_t) {
+		return SdoErrorCode::NoError;
+	});
+	// Records only contain the position
+	map.template setWriteHandler<CiA402Objects<Axis>::SizeOfDataRecord>(+[](uint8_t value) {
+		if (value != 1) return SdoErrorCode::InvalidValue;
+		return SdoErrorCode::NoError;
+	});
+	// 0 clears the buffer and rejects records, 1 accepts records again
+	map.template setWriteHandler<CiA402Objects<Axis>::BufferClear>(+[](uint8_t value) {
+		if (value > 1) return SdoErrorCode::InvalidValue;
+		if (value == 0)
+		{
+			interpolationBuffer_.clear();
+			interpolationOverflow_ = false;
+		}
+		interpolationBufferEnabled_ = (value == 1);
+		return SdoErrorCode::NoError;
+	});
+
 	map.template setReadHandler<CiA402Objects<Axis>::FaultReactionOptionCode>(
 		+[]() { return std::to_underlying(faultCode_); });
 	map.template setWriteHandler<CiA402Objects<Axis>::FaultReactionOptionCode>(+[](int16_t value) {
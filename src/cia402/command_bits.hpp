@@ -12,9 +12,10 @@ enum class CommandBits : uint16_t
 	QuickStop = (1 << 2),
 	EnableOperation = (1 << 3),
 	// 4-6: Mode Specific
-	NewSetPoint = (1 << 4),        // ProfilePosition
-	ChangeImmediately = (1 << 5),  // ProfilePosition(TODO implement)
-	IsRelative = (1 << 6),         // ProfilePosition
+	NewSetPoint = (1 << 4),          // ProfilePosition
+	ChangeImmediately = (1 << 5),    // ProfilePosition(TODO implement)
+	IsRelative = (1 << 6),           // ProfilePosition
+	EnableInterpolation = (1 << 4),  // InterpolatedPosition
 
 	FaultReset = (1 << 7),
 	Halt = (1 << 8),  // TODO(implement)
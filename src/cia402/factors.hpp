@@ -1,5 +1,6 @@
 #ifndef CANOPEN_FACTORS_HPP
 #define CANOPEN_FACTORS_HPP
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 #include <limits>
@@ -24,10 +25,10 @@ struct ScalingFactor
 	toUser(Internal internal) const;
 };
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance>
 class CiA402;
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance = 0>
 class CiA402Factors
 {
 public:
@@ -56,7 +57,7 @@ public:
 	getPolarity();
 
 protected:
-	friend class CiA402<Axis>;
+	friend class CiA402<Axis, Instance>;
 
 	template<typename OD>
 	constexpr static inline void
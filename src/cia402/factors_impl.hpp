@@ -41,25 +41,25 @@ ScalingFactor::toUser(Internal internal) const
 	return static_cast<User>(result);
 }
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance>
 void
-CiA402Factors<Axis>::setPolarity(uint8_t polarity)
+CiA402Factors<Axis, Instance>::setPolarity(uint8_t polarity)
 {
 	positionInverted = (bool)(polarity & (1 << 7));
 	velocityInverted = (bool)(polarity & (1 << 6));
 }
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance>
 uint8_t
-CiA402Factors<Axis>::getPolarity()
+CiA402Factors<Axis, Instance>::getPolarity()
 {
 	return (positionInverted ? (1 << 7) : 0) | (velocityInverted ? (1 << 6) : 0);
 }
 
-template<uint8_t Axis>
+template<uint8_t Axis, std::size_t Instance>
 template<typename OD>
 constexpr void
-CiA402Factors<Axis>::registerHandlers(HandlerMap<OD>& map)
+CiA402Factors<Axis, Instance>::registerHandlers(HandlerMap<OD>& map)
 {
 	map.template setReadHandler<ScalingObjects<Axis>::PositionEncoderResolutionNumerator>(
 		+[]() { return positionEncoderResolution.numerator; });
@@ -5,6 +5,6 @@ namespace modm_canopen::cia402
 enum class ProfileType : int16_t
 {
 	LinearRamp = 0,
-	// Sin2Ramp = 1
+	Sin2Ramp = 1
 };
 }
\ No newline at end of file
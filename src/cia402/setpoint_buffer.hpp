@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace modm_canopen::cia402
+{
+
+/// Lock-free single producer, single consumer FIFO of setpoints, e.g. filled from CAN reception
+/// and emptied by the control loop. Neither side ever waits for the other one.
+template<typename T, std::size_t Capacity>
+class SetpointBuffer
+{
+public:
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+				  "Capacity must be a power of two");
+
+	/// Producer only. Fails if limit values are buffered already, the value is dropped and
+	/// counted as overflow.
+	bool
+	push(const T& value, std::size_t limit = Capacity)
+	{
+		const std::size_t tail = tail_.load(std::memory_order_relaxed);
+		if (tail - head_.load(std::memory_order_acquire) >= std::min(limit, Capacity))
+		{
+			overflows_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		values_[tail % Capacity] = value;
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Producer only. Drops all values pushed so far, their space is available again after the
+	/// next pop() or discardCleared().
+	void
+	clear()
+	{
+		clearTo_.store(tail_.load(std::memory_order_relaxed), std::memory_order_release);
+	}
+
+	/// Consumer only
+	std::optional<T>
+	pop()
+	{
+		discardCleared();
+		const std::size_t head = head_.load(std::memory_order_relaxed);
+		if (head == tail_.load(std::memory_order_acquire)) return {};
+		const T value = values_[head % Capacity];
+		head_.store(head + 1, std::memory_order_release);
+		return value;
+	}
+
+	/// Consumer only
+	void
+	discardCleared()
+	{
+		const std::size_t head = head_.load(std::memory_order_relaxed);
+		const std::size_t clearTo = clearTo_.load(std::memory_order_acquire);
+		if (std::ptrdiff_t(clearTo - head) > 0) { head_.store(clearTo, std::memory_order_release); }
+	}
+
+	/// Number of buffered values, including cleared ones not discarded yet
+	std::size_t
+	size() const
+	{
+		return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+	}
+
+	/// Values dropped because the buffer was full
+	uint32_t
+	overflows() const
+	{
+		return overflows_.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::array<T, Capacity> values_{};
+	std::atomic<std::size_t> tail_{0};
+	std::atomic<std::size_t> head_{0};
+	std::atomic<std::size_t> clearTo_{0};
+	std::atomic<uint32_t> overflows_{0};
+};
+
+}  // namespace modm_canopen::cia402
@@ -0,0 +1,103 @@
+#pragma once
+#include <modm/architecture/interface/clock.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace modm_canopen::cia402
+{
+
+/// Interpolation sub mode (0x60C0), negative values are manufacturer specific
+enum class InterpolationType : int16_t
+{
+	Linear = 0,
+	Cubic = -1,
+};
+
+/// Interpolates setpoints received once per SYNC at the local control rate. The output lags one
+/// setpoint behind: within one period after a setpoint arrived it moves from the previous one to
+/// it, then holds it until the next one arrives.
+/// The cubic spline takes the difference to the setpoint before as slope at both ends of the
+/// segment, so the derivative is continuous across setpoints as well. Differences are computed
+/// modulo 2^32, so positions may wrap around.
+class SetpointInterpolator
+{
+public:
+	using time_point = modm::PreciseClock::time_point;
+
+	/// Holds value until the next setpoint
+	void
+	reset(int32_t value, time_point now)
+	{
+		setpoints_.fill(value);
+		received_ = now;
+		interval_ = 0;
+	}
+
+	void
+	push(int32_t setpoint, time_point now)
+	{
+		interval_ = elapsed(now);
+		received_ = now;
+		setpoints_ = {setpoints_[1], setpoints_[2], setpoint};
+	}
+
+	/// Interpolated setpoint, period in us. A period of 0 returns the last setpoint.
+	int32_t
+	evaluate(time_point now, uint32_t period, InterpolationType type) const
+	{
+		if (period == 0) return setpoints_[2];
+		const int64_t before = difference(setpoints_[1], setpoints_[0]);
+		const int64_t delta = difference(setpoints_[2], setpoints_[1]);
+		// Fraction of the period in Q16
+		const int64_t f = std::min<int64_t>((int64_t(elapsed(now)) << 16) / period, 1 << 16);
+		int64_t offset = 0;
+		if (type == InterpolationType::Cubic)
+		{
+			// Hermite basis functions relative to setpoints_[1]
+			const int64_t f2 = (f * f) >> 16;
+			const int64_t f3 = (f2 * f) >> 16;
+			offset = (delta * (3 * f2 - 2 * f3) + before * (f3 - 2 * f2 + f) + delta * (f3 - f2)) >>
+					 16;
+		} else
+		{
+			offset = (delta * f) >> 16;
+		}
+		return int32_t(uint32_t(setpoints_[1]) + uint32_t(offset));
+	}
+
+	int32_t
+	last() const
+	{
+		return setpoints_[2];
+	}
+
+	/// Time between the last two setpoints in us, 0 after reset()
+	uint32_t
+	interval() const
+	{
+		return interval_;
+	}
+
+private:
+	// Oldest first
+	std::array<int32_t, 3> setpoints_{};
+	time_point received_{};
+	uint32_t interval_{0};
+
+	uint32_t
+	elapsed(time_point now) const
+	{
+		using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+		return std::max<SignedRep>(0, SignedRep((now - received_).count()));
+	}
+
+	static int64_t
+	difference(int32_t a, int32_t b)
+	{
+		return int32_t(uint32_t(a) - uint32_t(b));
+	}
+};
+
+}  // namespace modm_canopen::cia402
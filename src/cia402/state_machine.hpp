@@ -93,7 +93,7 @@ public:
 	setBit(bool value)
 	{
 		// Dont accidentally change state
-		static_assert(std::to_underlying(bit) & StateMask == 0);
+		static_assert((std::to_underlying(bit) & StateMask) == 0);
 		status_ = (status_ & ~std::to_underlying(bit)) | (value ? std::to_underlying(bit) : 0);
 	}
 
@@ -32,6 +32,8 @@ enum class StatusBits : uint16_t
 	InterpolationModeActive = (1 << 12),  // Interpolation Position Mode
 
 	// 14-15: Manufacturer defined
+	BufferUnderflow = (1 << 14),  // Interpolation Position Mode
+	BufferOverflow = (1 << 15),   // Interpolation Position Mode
 };
 
 }  // namespace cia402
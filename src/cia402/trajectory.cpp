@@ -2,75 +2,211 @@
 #include <algorithm>
 using namespace modm_canopen::cia402;
 
+struct TrajectoryBase::Planner
+{
+	Plan& segments;
+	int count{0};
+
+	void
+	appendSegment(State& state, double duration, double jerk);
+
+	/// Appends a velocity change with zero acceleration at both ends
+	void
+	appendVelocityChange(State& state, double velocity, double acceleration, double jerk);
+
+	static double
+	velocityChangeDuration(double from, double to, double acceleration, double jerk);
+
+	/// Seven segments from state.velocity (towards the target, below the limit) to rest
+	void
+	appendDoubleS(State& state, double distance, double velocity, double acceleration,
+				  double jerk);
+};
+
 void
-Trajectory::update(uint32_t timeStep)
+TrajectoryBase::setLimits(uint32_t maxVelocity, uint32_t maxAcceleration, uint32_t maxJerk)
 {
-	// Clamp to limits
-	const auto limitedAccel = std::clamp(profileAcceleration_, 0u, maxAcceleration_);
-	const auto limitedVel = std::clamp(profileVelocity_, -maxVelocity_, maxVelocity_);
-	const auto limitedTargetPos = std::clamp(targetPos_, minPosition_, maxPosition_);
+	maxVelocity_ = maxVelocity;
+	maxAcceleration_ = maxAcceleration;
+	maxJerk_ = maxJerk;
+}
 
-	// This is currently a trapezoidal position step
-	// Check if we are even going in the right direction
-	auto shouldBrake =
-		std::signbit(limitedTargetPos - startPos_) != std::signbit(currentVel_) && currentVel_ != 0;
+void
+TrajectoryBase::setProfile(uint32_t velocity, uint32_t acceleration, uint32_t jerk)
+{
+	profileVelocity_ = velocity;
+	profileAcceleration_ = acceleration;
+	profileJerk_ = jerk;
+}
+
+void
+TrajectoryBase::setPositionLimits(int32_t minPosition, int32_t maxPosition)
+{
+	minPosition_ = minPosition;
+	maxPosition_ = maxPosition;
+}
 
-	if (!shouldBrake)
+void
+TrajectoryBase::Planner::appendSegment(State& state, double duration, double jerk)
+{
+	if (duration <= 0) return;
+	const auto micros = std::llround(duration * 1e6);
+	if (micros > 0 && count < (int)segments.size())
 	{
-		// If we are check if we have to brake at the desired decel to make it
-		const auto timeToBrake =
-			(std::round(std::abs((float)currentVel_ / (limitedAccel * timeStep))) * timeStep);
-		const auto posAfterBraking = (currentPos_ + currentVel_ * timeToBrake +
-									  (0.5 * -(limitedAccel * timeToBrake * timeToBrake)) *
-										  (std::signbit(currentVel_) ? 1 : -1));
-
-		// Depending on movement direction brake if we would otherwise overshoot
-		if (limitedTargetPos >= startPos_)
-		{
-			shouldBrake = posAfterBraking >= limitedTargetPos;
-		} else
-		{
-			shouldBrake = posAfterBraking <= limitedTargetPos;
-		}
+		segments[count++] = PlannedSegment{
+			.duration = (uint32_t)std::min<long long>(micros, std::numeric_limits<uint32_t>::max()),
+			.position = state.position,
+			.velocity = state.velocity,
+			.acceleration = state.acceleration,
+			.jerk = jerk};
+	}
+	// Integrate exactly, so rounding does not accumulate over the segments
+	const double t = duration;
+	state.position += t * (state.velocity + t * (state.acceleration / 2 + t * jerk / 6));
+	state.velocity += t * (state.acceleration + t * jerk / 2);
+	state.acceleration += t * jerk;
+}
+
+double
+TrajectoryBase::Planner::velocityChangeDuration(double from, double to, double acceleration,
+												double jerk)
+{
+	const double change = std::abs(to - from);
+	if (change * jerk < acceleration * acceleration) return 2 * std::sqrt(change / jerk);
+	return acceleration / jerk + change / acceleration;
+}
+
+void
+TrajectoryBase::Planner::appendVelocityChange(State& state, double velocity,
+											  double acceleration, double jerk)
+{
+	const double change = velocity - state.velocity;
+	const double direction = (change < 0) ? -1 : 1;
+	double jerkTime = acceleration / jerk;
+	double constantTime = std::abs(change) / acceleration - jerkTime;
+	if (constantTime < 0)
+	{
+		jerkTime = std::sqrt(std::abs(change) / jerk);
+		constantTime = 0;
 	}
+	appendSegment(state, jerkTime, direction * jerk);
+	appendSegment(state, constantTime, 0);
+	appendSegment(state, jerkTime, -direction * jerk);
+	state.velocity = velocity;
+	state.acceleration = 0;
+}
 
-	// Select the velocity we actually want to reach
-	int32_t targetVel = targetPos_ < startPos_ ? -limitedVel : limitedVel;
+void
+TrajectoryBase::Planner::appendDoubleS(State& state, double distance, double velocity,
+									   double acceleration, double jerk)
+{
+	// Biagiotti, Melchiorri: Trajectory Planning for Automatic Machines and Robots, 3.4
+	// Normalized to positive direction, final velocity 0
+	const double direction = (distance < 0) ? -1 : 1;
+	const double h = std::abs(distance);
+	const double v0 = direction * state.velocity;
+	if (h <= 0 && v0 <= 0) return;
 
-	if (shouldBrake)
+	double jerkTime1, jerkTime2, accelerationTime, decelerationTime, cruiseTime;
+	// Velocity limit reached
+	if ((velocity - v0) * jerk < acceleration * acceleration)
 	{
-		// If we want to brake, accelerate against our current velocity
-		outAccel_ = (std::signbit(currentVel_) ? limitedAccel : -limitedAccel);
-		targetVel = 0;
-	} else if (currentVel_ > targetVel)
+		jerkTime1 = std::sqrt((velocity - v0) / jerk);
+		accelerationTime = 2 * jerkTime1;
+	} else
 	{
-		// If velocity is too high, decelerate
-		outAccel_ = -limitedAccel;
-	} else if (currentVel_ < targetVel)
+		jerkTime1 = acceleration / jerk;
+		accelerationTime = jerkTime1 + (velocity - v0) / acceleration;
+	}
+	if (velocity * jerk < acceleration * acceleration)
 	{
-		// If velocity is too low, acccelerate
-		outAccel_ = limitedAccel;
+		jerkTime2 = std::sqrt(velocity / jerk);
+		decelerationTime = 2 * jerkTime2;
 	} else
 	{
-		// We are at the correct velocity
-		outAccel_ = 0;
+		jerkTime2 = acceleration / jerk;
+		decelerationTime = jerkTime2 + velocity / acceleration;
 	}
+	cruiseTime = h / velocity - accelerationTime / 2 * (1 + v0 / velocity) - decelerationTime / 2;
 
-	// Intergrate desired output velocity
-	outVel_ = currentVel_ + outAccel_ * timeStep;
-	if (std::abs(outVel_) > (int32_t)maxVelocity_)
+	if (cruiseTime < 0)
 	{
-		// Remove overshoot due to maximum
-		outAccel_ -= (outVel_ - std::copysign(maxVelocity_, outVel_)) / timeStep;
-		outVel_ = currentVel_ + outAccel_ * timeStep;
+		// Velocity limit not reached, lower the acceleration until both phases have one
+		cruiseTime = 0;
+		for (double a = acceleration; a > acceleration * 1e-6; a *= 0.99)
+		{
+			const double jerkTime = a / jerk;
+			const double delta = a * a * a * a / (jerk * jerk) + 2 * v0 * v0 +
+								 a * (4 * h - 2 * a / jerk * v0);
+			accelerationTime = (a * a / jerk - 2 * v0 + std::sqrt(delta)) / (2 * a);
+			decelerationTime = (a * a / jerk + std::sqrt(delta)) / (2 * a);
+			if (accelerationTime < 0)
+			{
+				// Decelerating all the way
+				accelerationTime = jerkTime1 = 0;
+				decelerationTime = 2 * h / v0;
+				jerkTime2 =
+					(jerk * h - std::sqrt(std::max(0.0, jerk * (jerk * h * h - v0 * v0 * v0)))) /
+					(jerk * v0);
+				break;
+			}
+			jerkTime1 = jerkTime2 = jerkTime;
+			if (accelerationTime >= 2 * jerkTime && decelerationTime >= 2 * jerkTime) break;
+		}
+		// Short moves never reach the acceleration limit
+		jerkTime1 = std::min(jerkTime1, accelerationTime / 2);
+		jerkTime2 = std::min(jerkTime2, decelerationTime / 2);
 	}
-	if (isBetween(targetVel, outVel_, currentVel_))
+
+	const double j = direction * jerk;
+	appendSegment(state, jerkTime1, j);
+	appendSegment(state, accelerationTime - 2 * jerkTime1, 0);
+	appendSegment(state, jerkTime1, -j);
+	appendSegment(state, cruiseTime, 0);
+	appendSegment(state, jerkTime2, -j);
+	appendSegment(state, decelerationTime - 2 * jerkTime2, 0);
+	appendSegment(state, jerkTime2, j);
+}
+
+int
+TrajectoryBase::plan(int32_t target, Plan& segments)
+{
+	targetPos_ = std::clamp(target, minPosition_, maxPosition_);
+
+	const double velocity = std::min(profileVelocity_, maxVelocity_);
+	const double acceleration = std::min(profileAcceleration_, maxAcceleration_);
+	const uint32_t jerkLimit = std::min(profileJerk_, maxJerk_);
+	if (velocity <= 0 || acceleration <= 0) return -1;
+	// Without jerk limit the acceleration steps within a microsecond
+	const double jerk = (jerkLimit == 0) ? acceleration * 1e6 : (double)jerkLimit;
+
+	Planner planner{segments};
+	State state{(double)outPos_, (double)outVel_, 0};
+	double distance = targetPos_ - state.position;
+	const double direction = (distance < 0) ? -1 : 1;
+	const double v0 = direction * state.velocity;
+	auto stoppingDistance = [&](double v) {
+		return v * Planner::velocityChangeDuration(v, 0, acceleration, jerk) / 2;
+	};
+
+	// Moving away, too fast, or unable to stop in time: slow down first
+	if (v0 > velocity)
+	{
+		const double slowDown =
+			(v0 + velocity) * Planner::velocityChangeDuration(v0, velocity, acceleration, jerk) / 2;
+		if (slowDown + stoppingDistance(velocity) <= std::abs(distance))
+		{
+			planner.appendVelocityChange(state, direction * velocity, acceleration, jerk);
+		} else
+		{
+			planner.appendVelocityChange(state, 0, acceleration, jerk);
+		}
+	} else if (v0 < 0 || stoppingDistance(v0) > std::abs(distance))
 	{
-		// Remove overshoot due to timesteps
-		outAccel_ -= (outVel_ - targetVel) / timeStep;
-		outVel_ = currentVel_ + outAccel_ * timeStep;
+		planner.appendVelocityChange(state, 0, acceleration, jerk);
 	}
-	// Integrate desired output velocity
-	outPos_ = currentPos_ + outVel_ * timeStep;
-	// If we remove overshoot here we generate really high accelerations
-}
\ No newline at end of file
+
+	distance = targetPos_ - state.position;
+	planner.appendDoubleS(state, distance, velocity, acceleration, jerk);
+	return planner.count;
+}
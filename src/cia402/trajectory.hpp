@@ -1,49 +1,315 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cmath>
+#include <limits>
 
 namespace modm_canopen::cia402
 {
-class Trajectory
+/// Planned segment with constant jerk, as computed by TrajectoryBase::plan()
+struct PlannedSegment
 {
+	uint32_t duration;  // us
+	double position;
+	double velocity;
+	double acceleration;
+	double jerk;
+};
+
+/// Evaluates segments in double precision, for hosts and MCUs with a double precision FPU. Single
+/// precision loses whole steps over the distance of a long segment and emulated double is slow,
+/// so it is not the default.
+struct DoubleArithmetic
+{
+	struct Segment
+	{
+		uint32_t duration;  // us
+		int32_t position;
+		double offset;  // fractional start position
+		double velocity;
+		double acceleration;
+		double jerk;
+	};
+
+	static Segment
+	segment(const PlannedSegment& planned)
+	{
+		const auto position = std::floor(planned.position);
+		return Segment{.duration = planned.duration,
+					   .position = (int32_t)(int64_t)position,
+					   .offset = planned.position - position,
+					   .velocity = planned.velocity,
+					   .acceleration = planned.acceleration,
+					   .jerk = planned.jerk};
+	}
+
+	static void
+	evaluate(const Segment& s, uint32_t elapsed, int32_t& position, int32_t& velocity,
+			 int32_t& acceleration)
+	{
+		const double t = elapsed * 1e-6;
+		acceleration = std::lround(s.acceleration + s.jerk * t);
+		velocity = std::lround(s.velocity + t * (s.acceleration + s.jerk * t / 2));
+		const double distance = t * (s.velocity + t * (s.acceleration / 2 + s.jerk * t / 6));
+		// Unsigned addition wraps, the conversion back to int32_t is modular
+		position = int32_t(uint32_t(s.position) + uint32_t(std::llround(s.offset + distance)));
+	}
+};
+
+/// Evaluates segments with integer multiplies and shifts only, the default as it is exact and fast
+/// with or without single precision FPU. The polynomials are in the normalized segment time
+/// tau = t / duration, so no division is left per update. Positions wrap around like the int32_t
+/// they are stored in.
+struct FixedPointArithmetic
+{
+	static constexpr int FractionBits = 16;
+
+	struct Segment
+	{
+		uint32_t duration;  // us
+		// tau in Q31 is (elapsed * tauFactor) >> tauShift
+		uint32_t tauFactor;
+		uint8_t tauShift;
+		int32_t position;
+		// Coefficients of tau^0..3 with FractionBits fractional bits
+		std::array<int64_t, 4> positionCoefficients;
+		std::array<int64_t, 3> velocityCoefficients;
+		std::array<int64_t, 2> accelerationCoefficients;
+	};
+
+	static Segment
+	segment(const PlannedSegment& planned)
+	{
+		Segment s{};
+		s.duration = planned.duration;
+		// Largest factor below 2^32 keeps the most precision
+		const uint32_t duration = std::max<uint32_t>(planned.duration, 1);
+		s.tauShift = 0;
+		while (s.tauShift < 32 && (uint64_t(1) << s.tauShift) < duration) { ++s.tauShift; }
+		s.tauFactor = (uint32_t)std::min<double>(
+			std::round(std::ldexp(1.0, 31 + s.tauShift) / duration),
+			std::numeric_limits<uint32_t>::max());
+
+		const double t = duration * 1e-6;
+		const double scale = std::ldexp(1.0, FractionBits);
+		const auto position = std::floor(planned.position);
+		s.position = (int32_t)(int64_t)position;
+		s.positionCoefficients = {
+			std::llround((planned.position - position) * scale),
+			std::llround(planned.velocity * t * scale),
+			std::llround(planned.acceleration * t * t / 2 * scale),
+			std::llround(planned.jerk * t * t * t / 6 * scale)};
+		s.velocityCoefficients = {std::llround(planned.velocity * scale),
+								  std::llround(planned.acceleration * t * scale),
+								  std::llround(planned.jerk * t * t / 2 * scale)};
+		s.accelerationCoefficients = {std::llround(planned.acceleration * scale),
+									  std::llround(planned.jerk * t * scale)};
+		return s;
+	}
+
+	static void
+	evaluate(const Segment& s, uint32_t elapsed, int32_t& position, int32_t& velocity,
+			 int32_t& acceleration)
+	{
+		const uint32_t tau =
+			std::min<uint64_t>((uint64_t(elapsed) * s.tauFactor) >> s.tauShift, uint32_t(1) << 31);
+		acceleration = toInteger(horner(s.accelerationCoefficients, tau));
+		velocity = toInteger(horner(s.velocityCoefficients, tau));
+		// Unsigned addition wraps, the conversion back to int32_t is modular
+		position = int32_t(uint32_t(s.position) + uint32_t(toInteger(horner(s.positionCoefficients,
+																		   tau))));
+	}
+
 private:
-	uint32_t currentTime_{0};
-	int32_t currentVel_{0};
-	int32_t currentPos_{0};
+	/// value * tau / 2^31 for |value| < 2^62 with two 32x32 bit multiplies
+	static int64_t
+	multiplyTau(int64_t value, uint32_t tau)
+	{
+		const bool negative = value < 0;
+		const uint64_t magnitude = negative ? -uint64_t(value) : uint64_t(value);
+		const uint64_t high = (magnitude >> 32) * tau;
+		const uint64_t low = (magnitude & 0xFFFF'FFFF) * tau;
+		const uint64_t product = (high << 1) + (low >> 31);
+		return negative ? -int64_t(product) : int64_t(product);
+	}
+
+	template<std::size_t N>
+	static int64_t
+	horner(const std::array<int64_t, N>& coefficients, uint32_t tau)
+	{
+		int64_t result = coefficients[N - 1];
+		for (std::size_t i = N - 1; i > 0; --i)
+		{
+			result = coefficients[i - 1] + multiplyTau(result, tau);
+		}
+		return result;
+	}
 
-	int32_t startVel_{0};
-	int32_t startPos_{0};
+	static int64_t
+	toInteger(int64_t value)
+	{
+		// Rounds half up, the arithmetic shift floors negative values
+		return (value + (int64_t(1) << (FractionBits - 1))) >> FractionBits;
+	}
+};
+
+/// Limits, outputs and planning shared by all arithmetic variants of BasicTrajectory
+class TrajectoryBase
+{
+protected:
+	// Stopping or slowing down to the velocity limit, then seven segments to the target
+	static constexpr std::size_t MaxSegments = 10;
+	using Plan = std::array<PlannedSegment, MaxSegments>;
+
+	struct State
+	{
+		double position;
+		double velocity;
+		double acceleration;
+	};
 
 	int32_t outPos_{0};
 	int32_t outVel_{0};
 	int32_t outAccel_{0};
 
-    int32_t targetPos_{0};
+	int32_t targetPos_{0};
+
+	uint32_t profileJerk_{0};
+	uint32_t profileAcceleration_{0};
+	uint32_t profileVelocity_{0};
 
-    uint32_t profileJerk_{0};
-    uint32_t profileAcceleration_{0};
-    uint32_t profileVelocity_{0};
+	uint32_t maxJerk_{std::numeric_limits<uint32_t>::max()};
+	uint32_t maxAcceleration_{std::numeric_limits<uint32_t>::max()};
+	uint32_t maxVelocity_{std::numeric_limits<uint32_t>::max()};
+	int32_t maxPosition_{std::numeric_limits<int32_t>::max()};
+	int32_t minPosition_{std::numeric_limits<int32_t>::min()};
 
-	uint32_t maxJerk_{0};
-	uint32_t maxAcceleration_{0};
-	uint32_t maxVelocity_{0};
-	int32_t maxPosition_{1000};
-	int32_t minPosition_{-1000};
+	/// Plans from the outputs to target, returns the number of segments. -1 if velocity or
+	/// acceleration limit are 0.
+	int
+	plan(int32_t target, Plan& segments);
 
-	static inline bool
-	isBetween(int32_t val, int32_t limA, int32_t limB)
+private:
+	struct Planner;
+
+public:
+	/// Effective limits are the lower of profile and maximum values
+	void
+	setLimits(uint32_t maxVelocity, uint32_t maxAcceleration, uint32_t maxJerk);
+	void
+	setProfile(uint32_t velocity, uint32_t acceleration, uint32_t jerk);
+	/// Targets are clamped to the position range
+	void
+	setPositionLimits(int32_t minPosition, int32_t maxPosition);
+
+	int32_t
+	position() const
+	{
+		return outPos_;
+	}
+
+	int32_t
+	velocity() const
 	{
-		const auto minV = std::min(limA, limB);
-		const auto maxV = std::max(limA, limB);
-		return minV <= val && val <= maxV;
+		return outVel_;
 	}
 
+	int32_t
+	acceleration() const
+	{
+		return outAccel_;
+	}
+
+	int32_t
+	target() const
+	{
+		return targetPos_;
+	}
+};
+
+/// Jerk limited point to point trajectory (double S profile). setTarget() plans all segments
+/// from the current position and velocity to standing still at the target, update() then only
+/// evaluates the polynomial of the current segment with the given Arithmetic.
+/// Positions in internal units, derivatives per second, time steps in microseconds. A jerk limit
+/// of 0 gives a trapezoidal profile. Planning assumes zero acceleration at the start, so changing
+/// the target while accelerating causes an acceleration step.
+template<typename Arithmetic = FixedPointArithmetic>
+class BasicTrajectory : public TrajectoryBase
+{
+private:
+	std::array<typename Arithmetic::Segment, MaxSegments> segments_{};
+	uint8_t segmentCount_{0};
+	uint8_t segment_{0};
+	uint32_t elapsed_{0};  // us since the start of the current segment
+
 public:
-	Trajectory() = default;
-	~Trajectory() = default;
+	/// Stops planning and continues from the given state, e.g. the actual position
+	void
+	reset(int32_t position, int32_t velocity = 0)
+	{
+		outPos_ = position;
+		outVel_ = velocity;
+		outAccel_ = 0;
+		targetPos_ = position;
+		segmentCount_ = 0;
+		segment_ = 0;
+		elapsed_ = 0;
+	}
+
+	/// Plans the way to a new target, returns false if velocity or acceleration limit are 0
+	bool
+	setTarget(int32_t target)
+	{
+		Plan planned;
+		const int count = plan(target, planned);
+		segment_ = 0;
+		elapsed_ = 0;
+		segmentCount_ = (count < 0) ? 0 : count;
+		for (uint8_t i = 0; i < segmentCount_; ++i)
+		{
+			segments_[i] = Arithmetic::segment(planned[i]);
+		}
+		return count >= 0;
+	}
 
 	void
-	update(uint32_t timestep);
+	update(uint32_t timestep)
+	{
+		elapsed_ += timestep;
+		while (segment_ < segmentCount_ && elapsed_ >= segments_[segment_].duration)
+		{
+			elapsed_ -= segments_[segment_].duration;
+			++segment_;
+		}
+		if (segment_ >= segmentCount_)
+		{
+			elapsed_ = 0;
+			outPos_ = targetPos_;
+			outVel_ = 0;
+			outAccel_ = 0;
+			return;
+		}
+		Arithmetic::evaluate(segments_[segment_], elapsed_, outPos_, outVel_, outAccel_);
+	}
+
+	bool
+	isDone() const
+	{
+		return segment_ >= segmentCount_;
+	}
+
+	/// Total planned duration in us
+	uint64_t
+	duration() const
+	{
+		uint64_t total = 0;
+		for (uint8_t i = 0; i < segmentCount_; ++i) { total += segments_[i].duration; }
+		return total;
+	}
 };
 
-}  // namespace modm_canopen::cia402
\ No newline at end of file
+using Trajectory = BasicTrajectory<FixedPointArithmetic>;
+using DoubleTrajectory = BasicTrajectory<DoubleArithmetic>;
+
+}  // namespace modm_canopen::cia402
@@ -0,0 +1,187 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include "profile_type.hpp"
+
+namespace modm_canopen::cia402
+{
+
+namespace detail
+{
+// sin²(π/2 * i/Segments) in Q15, evaluated at compile time
+template<std::size_t Segments>
+consteval std::array<uint16_t, Segments + 1>
+makeSin2Table()
+{
+	constexpr double pi = 3.14159265358979323846;
+	std::array<uint16_t, Segments + 1> table{};
+	for (std::size_t i = 0; i <= Segments; ++i)
+	{
+		// sin²(x) = (1 - cos(2x)) / 2, cos by its Taylor series on [0, π]
+		const double x = pi * double(i) / Segments;
+		double term = 1.0;
+		double cos = 1.0;
+		for (int n = 1; n < 20; ++n)
+		{
+			term *= -x * x / ((2 * n - 1) * (2 * n));
+			cos += term;
+		}
+		table[i] = uint16_t((1.0 - cos) / 2.0 * 32768.0 + 0.5);
+	}
+	return table;
+}
+}  // namespace detail
+
+/// Velocity ramp generator for profile velocity mode and the stop reactions. Integer only: the
+/// linear ramp carries the sub-unit velocity change over to the next step, the sin² ramp
+/// (0x6086 = 1) interpolates a lookup table. Velocities in internal units per second,
+/// accelerations in internal units per second², time steps in microseconds.
+/// An acceleration of 0 disables the ramp, the target is reached immediately.
+class VelocityRamp
+{
+private:
+	static constexpr std::size_t Sin2Segments = 128;
+	static constexpr auto Sin2Table = detail::makeSin2Table<Sin2Segments>();
+	static constexpr int64_t Microseconds = 1'000'000;
+
+	int32_t velocity_{0};
+	int32_t target_{0};
+	ProfileType profile_{ProfileType::LinearRamp};
+	uint32_t acceleration_{0};
+	uint32_t deceleration_{0};
+
+	// Linear ramp: velocity change not applied yet, in units/s * µs/s
+	int64_t remainder_{0};
+
+	// sin² ramp: current segment from start_ to target_
+	int32_t start_{0};
+	uint64_t elapsed_{0};
+	uint64_t duration_{0};
+
+	bool
+	isDecelerating(int32_t from, int32_t to) const
+	{
+		return (from > 0 && to < from) || (from < 0 && to > from);
+	}
+
+	void
+	startSegment()
+	{
+		start_ = velocity_;
+		elapsed_ = 0;
+		const uint32_t rate = isDecelerating(velocity_, target_) ? deceleration_ : acceleration_;
+		const uint64_t delta = std::abs(int64_t(target_) - velocity_);
+		// The peak acceleration of sin² is π/2 times the mean, keep the peak at the given rate
+		duration_ = (rate == 0) ? 0 : (delta * 1'570'796 + rate - 1) / rate;
+		// Keeps the table position below from overflowing, about 12 days
+		duration_ = std::min<uint64_t>(duration_, uint64_t(1) << 40);
+	}
+
+	void
+	updateLinear(uint32_t timestep)
+	{
+		// Decelerate towards zero first when the target has the opposite sign
+		const bool decelerating = isDecelerating(velocity_, target_);
+		const int32_t stop = (decelerating && (target_ > 0) != (velocity_ > 0)) ? 0 : target_;
+		const uint32_t rate = decelerating ? deceleration_ : acceleration_;
+		if (rate == 0)
+		{
+			velocity_ = target_;
+			return;
+		}
+		const int64_t change = int64_t(rate) * timestep + remainder_;
+		const int64_t step = change / Microseconds;
+		remainder_ = change % Microseconds;
+
+		const int64_t distance = std::abs(int64_t(stop) - velocity_);
+		if (step >= distance)
+		{
+			velocity_ = stop;
+			remainder_ = 0;
+		} else
+		{
+			velocity_ += int32_t(velocity_ < stop ? step : -step);
+		}
+	}
+
+	void
+	updateSin2(uint32_t timestep)
+	{
+		elapsed_ += timestep;
+		if (elapsed_ >= duration_)
+		{
+			velocity_ = target_;
+			return;
+		}
+		// Table position in Q16, then linear interpolation between the entries
+		const uint64_t position = (elapsed_ * (Sin2Segments << 16)) / duration_;
+		const std::size_t index = position >> 16;
+		const uint32_t fraction = position & 0xFFFF;
+		const int32_t low = Sin2Table[index];
+		const int32_t high = Sin2Table[index + 1];
+		const int64_t factor = low + ((int64_t(high - low) * fraction) >> 16);  // Q15
+		const int64_t delta = int64_t(target_) - start_;
+		velocity_ = int32_t(start_ + ((delta * factor) >> 15));
+	}
+
+public:
+	/// Continue from the given velocity, e.g. the actual velocity when the ramp takes over
+	void
+	reset(int32_t velocity)
+	{
+		velocity_ = velocity;
+		target_ = velocity;
+		remainder_ = 0;
+		duration_ = 0;
+	}
+
+	/// A new target or profile during a sin² ramp starts a new segment from the current velocity
+	void
+	setTarget(int32_t target, uint32_t acceleration, uint32_t deceleration, ProfileType profile)
+	{
+		const bool changed = (target != target_ || acceleration != acceleration_ ||
+							  deceleration != deceleration_ || profile != profile_);
+		target_ = target;
+		acceleration_ = acceleration;
+		deceleration_ = deceleration;
+		profile_ = profile;
+		if (changed && profile_ == ProfileType::Sin2Ramp) { startSegment(); }
+	}
+
+	/// Advances the ramp by the time step, returns the velocity demand
+	int32_t
+	update(uint32_t timestep)
+	{
+		if (velocity_ == target_) return velocity_;
+		if (profile_ == ProfileType::Sin2Ramp)
+		{
+			updateSin2(timestep);
+		} else
+		{
+			updateLinear(timestep);
+		}
+		return velocity_;
+	}
+
+	int32_t
+	velocity() const
+	{
+		return velocity_;
+	}
+
+	int32_t
+	target() const
+	{
+		return target_;
+	}
+
+	bool
+	isDone() const
+	{
+		return velocity_ == target_;
+	}
+};
+
+}  // namespace modm_canopen::cia402
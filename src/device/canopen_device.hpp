@@ -2,8 +2,10 @@
 #define CANOPEN_CANOPEN_DEVICE_HPP
 
 #include <array>
+#include <atomic>
 #include <span>
 #include <optional>
+#include <utility>
 #include "handler_map.hpp"
 
 #include "../nmt_state.hpp"
@@ -13,9 +15,17 @@
 #include "../receive_pdo_configurator.hpp"
 #include "../transmit_pdo_configurator.hpp"
 #include "../transmit_pdo.hpp"
+#include "../next_deadline.hpp"
 #include "sdo_server.hpp"
 #include "heartbeat.hpp"
+#include "lss_slave.hpp"
+#include "time_consumer.hpp"
+#include "parameter_storage.hpp"
 #include "identity.hpp"
+#include "error_history.hpp"
+#include "emcy_queue.hpp"
+#include "sync_pll.hpp"
+#include "sync_scheduler.hpp"
 
 namespace modm_canopen
 {
@@ -26,11 +36,14 @@ class CanopenDevice
 public:
 	static constexpr uint8_t MaxTPDOCount = 4;
 	static constexpr uint8_t MaxRPDOCount = 4;
+	/// EMCY messages raised faster than the inhibit time (0x1015) allows are queued
+	static constexpr std::size_t EmcyQueueSize = 8;
 
 	using ObjectDictionary = OD;
 	using ReceivePdo_t = ReceivePdo<OD>;
 	using TransmitPdo_t = TransmitPdo<OD>;
 
+	/// Pass LssUnconfiguredNodeId to have the node id assigned by an LSS master
 	static void
 	initialize(uint8_t nodeId, const Identity& id)
 	{
@@ -42,6 +55,10 @@ public:
 	setNodeId(uint8_t id);
 	static uint8_t
 	nodeId();
+	static bool
+	isConfigured();
+	static const Identity&
+	identity();
 	static NMTState
 	nmtState();
 
@@ -49,6 +66,38 @@ public:
 	isInSyncWindow();
 	static uint8_t
 	syncCounter();
+	/// Period and phase of the received SYNC, e.g. to schedule control loops against it
+	static const SyncPll&
+	syncPll();
+	/// SYNCs deviating less from their predicted time are never a communication error
+	static void
+	setMinimumSyncTolerance(std::chrono::microseconds tolerance);
+
+	/// SYNC production is enabled by bit 30 of 0x1005 and a non-zero period in 0x1006
+	static bool
+	isSyncProducer();
+	/// When the next SYNC is due, to arm a hardware timer that calls produceSync()
+	static modm::PreciseClock::time_point
+	nextSyncTime();
+	/// Leaves SYNC production to produceSync() called from a timer instead of update(). Enable
+	/// before arming the timer, disable after stopping it.
+	static void
+	setSyncTimerEnabled(bool enabled);
+	/// Only sends the SYNC frame, safe to call from a timer interrupt while update() and
+	/// processMessage() run. The next update() consumes the SYNC and sends the synchronous TPDOs,
+	/// so it has to run once per SYNC period. Returns false if not producing SYNC or the timer is
+	/// not enabled.
+	/// Without a wake callback the TPDOs are late by up to the time the main loop sleeps.
+	template<typename MessageCallback>
+	static bool
+	produceSync(MessageCallback&& cb);
+	/// Calls wake right after the SYNC was sent, still from the interrupt, to run update() at
+	/// once, e.g. by pending a low priority interrupt or resuming the fiber that runs update().
+	/// The TPDOs then follow the SYNC by the wake-up latency plus the part of update() before
+	/// them: the EMCY, heartbeat and SyncScheduler tasks that are due.
+	template<typename MessageCallback, typename WakeCallback>
+	static bool
+	produceSync(MessageCallback&& cb, WakeCallback&& wake);
 
 	static void
 	setValueChanged(Address address);
@@ -58,15 +107,32 @@ public:
 	static void
 	processMessage(const modm::can::Message& message, MessageCallback&& cb);
 
+	/// Returns when update() has to be called next at the latest, unless a message arrives first.
+	/// Protocols can return a deadline from their update(), if they return void they have none.
 	template<typename MessageCallback>
-	static void
+	static modm::PreciseClock::time_point
 	update(MessageCallback&& cb);
 
+	/// Longest interval returned by update() if nothing is pending
+	static constexpr modm::PreciseClock::duration MaxUpdateInterval{1s};
+
+	/// Protocols mark commands and setpoints with a static constexpr isProcessData(Address), those
+	/// are not restored by ParameterStorage
+	static constexpr bool
+	isProcessData(Address address)
+	{
+		return (isProtocolProcessData<Protocols>(address) || ...);
+	}
+
 private:
 	friend ReceivePdoConfigurator<CanopenDevice>;
 	friend TransmitPdoConfigurator<CanopenDevice>;
 	friend SdoServer<CanopenDevice>;
 	friend Heartbeat<CanopenDevice>;
+	friend LssSlave<CanopenDevice>;
+	friend TimeConsumer<CanopenDevice>;
+	friend ParameterStorage<CanopenDevice>;
+	friend SyncScheduler<CanopenDevice>;
 
 	using Map = HandlerMap<OD>;
 
@@ -77,6 +143,19 @@ private:
 
 	static constexpr HandlerMap<OD> accessHandlers = constructHandlerMap();
 
+	template<typename Protocol>
+	static constexpr bool
+	isProtocolProcessData(Address address)
+	{
+		if constexpr (requires { Protocol::isProcessData(address); })
+		{
+			return Protocol::isProcessData(address);
+		} else
+		{
+			return false;
+		}
+	}
+
 	static inline uint8_t nodeId_{};
 
 	static inline Identity deviceId_{};
@@ -90,36 +169,68 @@ private:
 	static inline bool wasInSyncWindow_{false};
 	static inline bool justLeftSyncWindow_{false};
 	static inline bool missedSync_{false};
+	static inline SyncPll syncPll_{};
+	static inline bool syncProducer_{false};
+	static inline bool syncProductionStarted_{false};
+	static inline modm::PreciseClock::time_point nextProducedSync_{};
+	static inline uint8_t producedSyncCounter_{0};
+
+	struct ProducedSync
+	{
+		modm::can::Message message;
+		modm::PreciseClock::time_point time;
+	};
+	static inline std::atomic<bool> syncTimerEnabled_{false};
+	// Written by produceSync(), alternating so the slot read by update() stays untouched for a
+	// whole SYNC period
+	static inline std::array<ProducedSync, 2> producedSyncs_{};
+	static inline std::atomic<uint32_t> producedSyncSequence_{0};
+	static inline uint32_t handledSyncSequence_{0};
 
 	static inline constinit std::array<ReceivePdo_t, MaxRPDOCount> receivePdos_;
 	static inline constinit std::array<TransmitPdo_t, MaxTPDOCount> transmitPdos_;
 
 	static void
-	handleSync(const modm::can::Message& msg);
+	handleSync(const modm::can::Message& msg, modm::PreciseClock::time_point now);
+
+	/// Sends the SYNC and advances the schedule, returns the frame sent
+	template<typename MessageCallback>
+	static modm::can::Message
+	sendSync(modm::PreciseClock::time_point now, MessageCallback&& cb);
 
 	static void
 	handleNMTCommand(const modm::can::Message& msg);
 
 	template<typename MessageCallback>
 	static void
-	sendEMCY(MessageCallback&& cb);
+	sendEMCY(const EmcyEntry& entry, MessageCallback&& cb);
+
+	template<typename Protocol, typename MessageCallback>
+	static void
+	updateProtocol(MessageCallback&& cb, NextDeadline& deadline);
 
 	static inline NMTState state_{NMTState::PreOperational};
 
-	static inline bool emcyDue_{false};
+	static inline constinit EmcyQueue<EmcyQueueSize> emcyQueue_{};
 	static inline modm::PreciseClock::time_point lastEmcyTime_{};
 	static inline modm::PreciseClock::duration emcyInhibitTime_{5ms};
 	static inline bool emcyEnabled_{true};
 	static inline uint32_t emcyCobId_{0x80u + nodeId_};
-	static inline EMCYError emcy_{EMCYError::NoError};
+	static inline std::atomic<EMCYError> emcy_{EMCYError::NoError};
+	static inline ErrorHistory<errorHistoryCapacity<OD>()> errorHistory_{};
 	static inline uint8_t errorReg_{0};
 	static inline std::array<uint8_t, 5> manufacturerError_{};
 
 public:
 	static EMCYError
 	getEMCYError();
+	/// Queues an EMCY message with the current error register and manufacturer error.
+	/// Safe to call from interrupts, except for communication errors which change the NMT state.
 	static void
 	setError(EMCYError emcy);
+	/// Number of EMCY messages dropped because the queue was full
+	static uint32_t
+	emcyOverflowCount();
 	static uint8_t&
 	getErrorRegister();
 	static std::array<uint8_t, 5>&
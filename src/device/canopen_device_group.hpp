@@ -0,0 +1,110 @@
+#ifndef CANOPEN_CANOPEN_DEVICE_GROUP_HPP
+#define CANOPEN_CANOPEN_DEVICE_GROUP_HPP
+
+#include <cstdint>
+#include <utility>
+
+#include "canopen_device.hpp"
+
+namespace modm_canopen
+{
+
+/// Same objects as OD, but a distinct type: every CanopenDevice<InstanceOD<OD, I>> has its own
+/// state
+template<typename OD, std::size_t Instance>
+struct InstanceOD : OD
+{};
+
+namespace detail
+{
+template<typename Protocol, std::size_t Instance>
+struct ProtocolForInstance
+{
+	using type = Protocol;
+};
+
+template<typename Protocol, std::size_t Instance>
+	requires requires { typename Protocol::template ForInstance<Instance>; }
+struct ProtocolForInstance<Protocol, Instance>
+{
+	using type = typename Protocol::template ForInstance<Instance>;
+};
+}  // namespace detail
+
+/// Count devices sharing OD and protocols in one process, e.g. to simulate a few drives on vcan.
+/// Protocols with static state provide template<std::size_t I> using ForInstance, so each device
+/// gets its own copy, like cia402::CiA402.
+/// Meant for a handful of devices: every device is a full instantiation of CanopenDevice and its
+/// protocols, so compile time and code size grow linearly with Count. With the CiA402 test OD
+/// GCC takes about 6.5 s for 4 devices and 35 s for 32. A larger simulated network is better
+/// served by a separate process per node.
+template<typename OD, std::size_t Count, typename... Protocols>
+class CanopenDeviceGroup
+{
+public:
+	template<std::size_t Instance>
+	using Device =
+		CanopenDevice<InstanceOD<OD, Instance>,
+					  typename detail::ProtocolForInstance<Protocols, Instance>::type...>;
+
+	static constexpr std::size_t
+	size()
+	{
+		return Count;
+	}
+
+	/// Device i gets node id firstNodeId + i and serial number id.serialNumber_ + i, so each one
+	/// has a unique LSS address. Pass LssUnconfiguredNodeId to leave all of them unconfigured.
+	static void
+	initialize(uint8_t firstNodeId, const Identity& id)
+	{
+		forEachIndexed([&]<typename D>(std::size_t index) {
+			Identity identity = id;
+			identity.serialNumber_ += index;
+			const bool unconfigured = (firstNodeId == LssUnconfiguredNodeId);
+			D::initialize(unconfigured ? firstNodeId : uint8_t(firstNodeId + index), identity);
+		});
+	}
+
+	/// Calls function.template operator()<Device<i>>() for every device
+	template<typename Function>
+	static void
+	forEach(Function&& function)
+	{
+		forEachIndexed([&]<typename D>(std::size_t) { function.template operator()<D>(); });
+	}
+
+	/// Passes the message to all devices
+	template<typename MessageCallback>
+	static void
+	processMessage(const modm::can::Message& message, MessageCallback&& cb)
+	{
+		forEach([&]<typename D>() { D::processMessage(message, cb); });
+	}
+
+	/// Updates all devices, returns the earliest deadline of them
+	template<typename MessageCallback>
+	static modm::PreciseClock::time_point
+	update(MessageCallback&& cb)
+	{
+		NextDeadline deadline{modm::PreciseClock::now(), Device<0>::MaxUpdateInterval};
+		forEach([&]<typename D>() { deadline.add(D::update(cb)); });
+		return deadline.value();
+	}
+
+private:
+	static_assert(Count > 0, "Device group must not be empty");
+
+	template<typename Function>
+	static void
+	forEachIndexed(Function&& function)
+	{
+		[&]<std::size_t... Instances>(std::index_sequence<Instances...>) {
+			(function.template operator()<Device<Instances>>(Instances), ...);
+		}(std::make_index_sequence<Count>{});
+	}
+};
+
+}  // namespace modm_canopen
+
+#endif  // CANOPEN_CANOPEN_DEVICE_GROUP_HPP
@@ -135,6 +135,11 @@ CanopenDevice<OD, Protocols...>::handleNMTCommand(const modm::can::Message& msg)
 			break;
 		case NMTCommand::ResetNode:
 			// TODO reset for real
+			LssSlave<CanopenDevice>::applyPendingNodeId();
+			state_ = NMTState::PreOperational;
+			break;
+		case NMTCommand::ResetCommunication:
+			LssSlave<CanopenDevice>::applyPendingNodeId();
 			state_ = NMTState::PreOperational;
 			break;
 		case NMTCommand::EnterPreOperational:
@@ -152,7 +157,8 @@ CanopenDevice<OD, Protocols...>::handleNMTCommand(const modm::can::Message& msg)
 
 template<typename OD, typename... Protocols>
 void
-CanopenDevice<OD, Protocols...>::handleSync(const modm::can::Message& message)
+CanopenDevice<OD, Protocols...>::handleSync(const modm::can::Message& message,
+										   modm::PreciseClock::time_point now)
 {
 	if (syncPeriod_.count() == 0) return;  // SYNC is disabled
 	if ((syncCounterOverflow_ == 0 && message.getLength() != 0) ||
@@ -174,13 +180,15 @@ CanopenDevice<OD, Protocols...>::handleSync(const modm::can::Message& message)
 		}
 		lastSyncCounter_ = newCounter;
 	}
-	const auto now = modm::PreciseClock::now();
-	const auto deviation = (int)(now - (lastSyncTime_ + syncPeriod_)).count();
-	if (lastSyncTime_.time_since_epoch().count() != 0 && syncPeriod_.count() != 0 &&
-		deviation > 1000)  // More than a millisecond inaccurate
+	// Deviations are judged against the jitter measured so far. Without a configured period
+	// (0x1006) the PLL follows whatever period the SYNC has, outliers are no error then.
+	if (!syncPll_.update(now))
 	{
-		MODM_LOG_DEBUG << "Got SYNC with deviation " << deviation << "us" << modm::endl;
-		setError(EMCYError::GenericCommunicationError);
+		const auto deviation = std::chrono::duration_cast<std::chrono::microseconds>(
+			syncPll_.lastError());
+		MODM_LOG_DEBUG << "Got SYNC with deviation " << (int)deviation.count() << "us"
+					   << modm::endl;
+		if (syncPll_.hasNominalPeriod()) { setError(EMCYError::GenericCommunicationError); }
 	} else
 	{
 		// Reset after one packet on time
@@ -193,23 +201,79 @@ CanopenDevice<OD, Protocols...>::handleSync(const modm::can::Message& message)
 
 template<typename OD, typename... Protocols>
 template<typename MessageCallback>
-void
-CanopenDevice<OD, Protocols...>::sendEMCY(MessageCallback&& cb)
+modm::can::Message
+CanopenDevice<OD, Protocols...>::sendSync(modm::PreciseClock::time_point now, MessageCallback&& cb)
 {
-	if (emcyEnabled_)
+	modm::can::Message message{syncCobId_, 0};
+	message.setExtended(syncCobId_ > 0x7FF);
+	if (syncCounterOverflow_ != 0)
 	{
-		emcyDue_ = false;
-		lastEmcyTime_ = modm::PreciseClock::now();
-		modm::can::Message msg{};
-		msg.setIdentifier(emcyCobId_);
-		msg.setExtended(false);
-		*((uint16_t*)msg.data) = (uint16_t)emcy_;
-		msg.data[2] = errorReg_;
-		std::copy(manufacturerError_.begin(), manufacturerError_.end(),
-				  std::span<uint8_t>(msg.data + 3, msg.capacity - 3).begin());
-		msg.setLength(3 + manufacturerError_.size());
-		cb(msg);
+		producedSyncCounter_ = (producedSyncCounter_ % syncCounterOverflow_) + 1;
+		message.setLength(1);
+		message.data[0] = producedSyncCounter_;
 	}
+	std::forward<MessageCallback>(cb)(message);
+
+	// Keep the period exact, skip SYNCs that are over already
+	using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+	do {
+		nextProducedSync_ += syncPeriod_;
+	} while (SignedRep((now - nextProducedSync_).count()) >= 0);
+	return message;
+}
+
+template<typename OD, typename... Protocols>
+template<typename MessageCallback>
+bool
+CanopenDevice<OD, Protocols...>::produceSync(MessageCallback&& cb)
+{
+	return produceSync(std::forward<MessageCallback>(cb), [] {});
+}
+
+template<typename OD, typename... Protocols>
+template<typename MessageCallback, typename WakeCallback>
+bool
+CanopenDevice<OD, Protocols...>::produceSync(MessageCallback&& cb, WakeCallback&& wake)
+{
+	if (!isSyncProducer() || !syncTimerEnabled_.load(std::memory_order_acquire)) return false;
+	const auto now = modm::PreciseClock::now();
+	using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+	// An early timer moves the schedule instead of skipping a SYNC
+	if (!syncProductionStarted_ || SignedRep((now - nextProducedSync_).count()) < 0)
+	{
+		syncProductionStarted_ = true;
+		nextProducedSync_ = now;
+	}
+	const auto message = sendSync(now, std::forward<MessageCallback>(cb));
+	const uint32_t sequence = producedSyncSequence_.load(std::memory_order_relaxed) + 1;
+	producedSyncs_[sequence % producedSyncs_.size()] = ProducedSync{message, now};
+	producedSyncSequence_.store(sequence, std::memory_order_release);
+	std::forward<WakeCallback>(wake)();
+	return true;
+}
+
+template<typename OD, typename... Protocols>
+void
+CanopenDevice<OD, Protocols...>::setSyncTimerEnabled(bool enabled)
+{
+	syncTimerEnabled_.store(enabled, std::memory_order_release);
+}
+
+template<typename OD, typename... Protocols>
+template<typename MessageCallback>
+void
+CanopenDevice<OD, Protocols...>::sendEMCY(const EmcyEntry& entry, MessageCallback&& cb)
+{
+	lastEmcyTime_ = modm::PreciseClock::now();
+	modm::can::Message msg{};
+	msg.setIdentifier(emcyCobId_);
+	msg.setExtended(false);
+	*((uint16_t*)msg.data) = (uint16_t)entry.error;
+	msg.data[2] = entry.errorRegister;
+	std::copy(entry.manufacturerError.begin(), entry.manufacturerError.end(),
+			  std::span<uint8_t>(msg.data + 3, msg.capacity - 3).begin());
+	msg.setLength(3 + entry.manufacturerError.size());
+	cb(msg);
 }
 
 template<typename OD, typename... Protocols>
@@ -218,9 +282,16 @@ void
 CanopenDevice<OD, Protocols...>::processMessage(const modm::can::Message& message,
 												MessageCallback&& cb)
 {
+	if (LssSlave<CanopenDevice>::processMessage(message, std::forward<MessageCallback>(cb)))
+	{
+		return;
+	}
+	if (!isConfigured()) return;
+
 	if (message.getIdentifier() == syncCobId_)
 	{
-		handleSync(message);
+		// A producer consumes its own SYNC when sending it
+		if (!syncProducer_) { handleSync(message, modm::PreciseClock::now()); }
 		return;
 	}
 	Heartbeat<CanopenDevice>::processMessage(message, std::forward<MessageCallback>(cb));
@@ -232,6 +303,7 @@ CanopenDevice<OD, Protocols...>::processMessage(const modm::can::Message& messag
 
 	if (state_ != NMTState::Stopped)
 	{
+		TimeConsumer<CanopenDevice>::processMessage(message, std::forward<MessageCallback>(cb));
 		if ((message.identifier & 0x7f) == nodeId_)
 		{
 			SdoServer<CanopenDevice>::processMessage(message, std::forward<MessageCallback>(cb));
@@ -264,30 +336,73 @@ CanopenDevice<OD, Protocols...>::processMessage(const modm::can::Message& messag
 
 template<typename OD, typename... Protocols>
 template<typename MessageCallback>
-void
+modm::PreciseClock::time_point
 CanopenDevice<OD, Protocols...>::update(MessageCallback&& cb)
 {
+	const auto now = modm::PreciseClock::now();
+	NextDeadline deadline{now, MaxUpdateInterval};
+	if (!isConfigured()) return deadline.value();
+
+	// The own SYNC is consumed like a received one, timestamped when it was sent
+	const uint32_t sequence = producedSyncSequence_.load(std::memory_order_acquire);
+	if (sequence != handledSyncSequence_)
+	{
+		handledSyncSequence_ = sequence;
+		const auto produced = producedSyncs_[sequence % producedSyncs_.size()];
+		handleSync(produced.message, produced.time);
+	}
+
 	const auto isInSync = isInSyncWindow();
 	justLeftSyncWindow_ = (wasInSyncWindow_ && !isInSync);
 	wasInSyncWindow_ = isInSync;
-	if (syncPeriod_.count() != 0 && lastSyncTime_.time_since_epoch().count() != 0)
+	if (isSyncProducer() && !syncTimerEnabled_.load(std::memory_order_acquire))
+	{
+		using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+		if (!syncProductionStarted_)
+		{
+			syncProductionStarted_ = true;
+			nextProducedSync_ = now;
+		}
+		// The synchronous TPDOs follow below in the same call
+		if (SignedRep((now - nextProducedSync_).count()) >= 0)
+		{
+			handleSync(sendSync(now, std::forward<MessageCallback>(cb)), now);
+		}
+		deadline.add(nextProducedSync_);
+	}
+	if (isInSync) { deadline.add(lastSyncTime_ + syncWindowDuration_); }
+	if (syncPeriod_.count() != 0 && syncPll_.isStarted() && syncPll_.hasNominalPeriod())
 	{
-		const auto now = modm::PreciseClock::now();
-		const auto timeSinceSync = now - lastSyncTime_;
-		if (timeSinceSync > syncPeriod_ + 1ms && !missedSync_)
+		const auto timeout =
+			syncPll_.syncTime(syncPll_.cycle() + 1) +
+			std::chrono::duration_cast<modm::PreciseClock::duration>(syncPll_.tolerance());
+		using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+		if (SignedRep((now - timeout).count()) > 0 && !missedSync_)
 		{
-			MODM_LOG_DEBUG << "Missed Sync by more than 1 ms!" << modm::endl;
+			MODM_LOG_DEBUG << "Missed Sync!" << modm::endl;
 			setError(EMCYError::GenericCommunicationError);
 			missedSync_ = true;
 		}
+		if (!missedSync_) { deadline.add(timeout + modm::PreciseClock::duration{1}); }
 	}
 
-	if (emcyDue_ && (lastEmcyTime_.time_since_epoch().count() == 0 ||
-					 modm::PreciseClock::now() - lastEmcyTime_ > emcyInhibitTime_))
+	// One queued EMCY per inhibit time, they stay queued while EMCY is disabled
+	if (emcyEnabled_ && (lastEmcyTime_.time_since_epoch().count() == 0 ||
+						 modm::PreciseClock::now() - lastEmcyTime_ > emcyInhibitTime_))
+	{
+		if (const auto entry = emcyQueue_.pop())
+		{
+			sendEMCY(*entry, std::forward<MessageCallback>(cb));
+		}
+	}
+	if (emcyEnabled_ && !emcyQueue_.empty())
 	{
-		sendEMCY(std::forward<MessageCallback>(cb));
+		deadline.add(lastEmcyTime_ + emcyInhibitTime_ + modm::PreciseClock::duration{1});
 	}
 	Heartbeat<CanopenDevice>::update(std::forward<MessageCallback>(cb));
+	Heartbeat<CanopenDevice>::addDeadlines(deadline);
+	// Before the TPDOs, so they carry the results of tasks that were due
+	SyncScheduler<CanopenDevice>::update(deadline);
 	if (state_ == NMTState::Operational)
 	{
 		for (auto& tpdo : transmitPdos_)
@@ -297,6 +412,7 @@ CanopenDevice<OD, Protocols...>::update(MessageCallback&& cb)
 				auto message = tpdo.nextMessage(isInSyncWindow(),
 												[](Address address) { return read(address); });
 				if (message) { std::forward<MessageCallback>(cb)(*message); }
+				tpdo.addDeadlines(deadline);
 			}
 		}
 		for (auto& rpdo : receivePdos_)
@@ -306,9 +422,27 @@ CanopenDevice<OD, Protocols...>::update(MessageCallback&& cb)
 				rpdo.template update<CanopenDevice>(wasInSyncWindow_);
 			}
 		}
-		(Protocols::template update<CanopenDevice, MessageCallback>(
-			 std::forward<MessageCallback>(cb)),
-		 ...);
+		(updateProtocol<Protocols>(std::forward<MessageCallback>(cb), deadline), ...);
+	}
+	return deadline.value();
+}
+
+template<typename OD, typename... Protocols>
+template<typename Protocol, typename MessageCallback>
+void
+CanopenDevice<OD, Protocols...>::updateProtocol(MessageCallback&& cb, NextDeadline& deadline)
+{
+	using Result = decltype(Protocol::template update<CanopenDevice, MessageCallback>(
+		std::forward<MessageCallback>(cb)));
+	if constexpr (std::is_same_v<Result, modm::PreciseClock::time_point>)
+	{
+		deadline.add(Protocol::template update<CanopenDevice, MessageCallback>(
+			std::forward<MessageCallback>(cb)));
+	} else
+	{
+		// Protocols without a deadline are only polled at MaxUpdateInterval
+		Protocol::template update<CanopenDevice, MessageCallback>(
+			std::forward<MessageCallback>(cb));
 	}
 }
 
@@ -336,6 +470,11 @@ template<typename OD, typename... Protocols>
 void
 CanopenDevice<OD, Protocols...>::setNodeId(uint8_t id)
 {
+	if (id == LssUnconfiguredNodeId)
+	{
+		nodeId_ = id;
+		return;
+	}
 	nodeId_ = id & 0x7f;
 	static_assert(transmitPdos_.size() <= 64);
 	static_assert(receivePdos_.size() <= 64);
@@ -360,6 +499,20 @@ CanopenDevice<OD, Protocols...>::nodeId()
 	return nodeId_;
 }
 
+template<typename OD, typename... Protocols>
+bool
+CanopenDevice<OD, Protocols...>::isConfigured()
+{
+	return nodeId_ != LssUnconfiguredNodeId;
+}
+
+template<typename OD, typename... Protocols>
+const Identity&
+CanopenDevice<OD, Protocols...>::identity()
+{
+	return deviceId_;
+}
+
 template<typename OD, typename... Protocols>
 NMTState
 CanopenDevice<OD, Protocols...>::nmtState()
@@ -367,6 +520,35 @@ CanopenDevice<OD, Protocols...>::nmtState()
 	return state_;
 }
 
+template<typename OD, typename... Protocols>
+const SyncPll&
+CanopenDevice<OD, Protocols...>::syncPll()
+{
+	return syncPll_;
+}
+
+template<typename OD, typename... Protocols>
+void
+CanopenDevice<OD, Protocols...>::setMinimumSyncTolerance(std::chrono::microseconds tolerance)
+{
+	syncPll_.setMinimumTolerance(tolerance);
+}
+
+template<typename OD, typename... Protocols>
+bool
+CanopenDevice<OD, Protocols...>::isSyncProducer()
+{
+	return syncProducer_ && syncPeriod_.count() != 0 && isConfigured() &&
+		   state_ != NMTState::Stopped;
+}
+
+template<typename OD, typename... Protocols>
+modm::PreciseClock::time_point
+CanopenDevice<OD, Protocols...>::nextSyncTime()
+{
+	return syncProductionStarted_ ? nextProducedSync_ : modm::PreciseClock::now();
+}
+
 template<typename OD, typename... Protocols>
 bool
 CanopenDevice<OD, Protocols...>::isInSyncWindow()
@@ -386,15 +568,23 @@ template<typename OD, typename... Protocols>
 EMCYError
 CanopenDevice<OD, Protocols...>::getEMCYError()
 {
-	return emcy_;
+	return emcy_.load(std::memory_order_relaxed);
+}
+
+template<typename OD, typename... Protocols>
+uint32_t
+CanopenDevice<OD, Protocols...>::emcyOverflowCount()
+{
+	return emcyQueue_.overflows();
 }
 
 template<typename OD, typename... Protocols>
 void
 CanopenDevice<OD, Protocols...>::setError(EMCYError emcy)
 {
-	emcyDue_ = true;
-	emcy_ = emcy;
+	emcy_.store(emcy, std::memory_order_relaxed);
+	emcyQueue_.push(EmcyEntry{emcy, errorReg_, manufacturerError_});
+	if (emcy != EMCYError::NoError) { errorHistory_.add((uint32_t)emcy); }
 	if (((uint16_t)emcy & 0xFF00) == (uint16_t)EMCYError::GenericCommunicationError)
 	{
 		// Handle communication error
@@ -428,27 +618,36 @@ CanopenDevice<OD, Protocols...>::registerHandlers() -> HandlerMap<OD>
 	HandlerMap<OD> handlers;
 	handlers.template setReadHandler<Address{0x1000, 0}>(+[]() { return deviceId_.deviceType_; });
 	handlers.template setReadHandler<Address{0x1001, 0}>(+[]() { return errorReg_; });
-	handlers.template setReadHandler<Address{0x1003, 0}>(+[]() {
-		if (emcy_ != EMCYError::NoError)
-			return (uint32_t)1;
-		else
-			return (uint32_t)0;
-	});
-	handlers.template setReadHandler<Address{0x1003, 1}>(+[]() { return (uint32_t)emcy_; });
+	handlers.template setReadHandler<Address{0x1003, 0}>(
+		+[]() { return (uint32_t)errorHistory_.size(); });
+	if constexpr (OD::map.lookup(Address{0x1003, 0})->isWritable())
+	{
+		handlers.template setWriteHandler<Address{0x1003, 0}>(+[](uint32_t val) {
+			// Only clearing the history is allowed
+			if (val != 0) return SdoErrorCode::InvalidValue;
+			errorHistory_.clear();
+			return SdoErrorCode::NoError;
+		});
+	}
+	[&handlers]<uint8_t... Subs>(std::integer_sequence<uint8_t, Subs...>) {
+		(handlers.template setReadHandler<Address{0x1003, Subs + 1}>(
+			 +[]() { return errorHistory_[Subs]; }),
+		 ...);
+	}(std::make_integer_sequence<uint8_t, errorHistoryCapacity<OD>()>{});
 
 	handlers.template setReadHandler<Address{0x1005, 0}>(+[]() {
 		const bool extended = ((syncCobId_ & 0x1FFFF800) != 0);
-		return (syncCobId_ & 0x1FFFFFFFu) | (extended ? 0x20000000u : 0x00000000u);
+		return (syncCobId_ & 0x1FFFFFFFu) | (extended ? 0x20000000u : 0x00000000u) |
+			   (syncProducer_ ? 0x40000000u : 0x00000000u);
 	});
 	handlers.template setWriteHandler<Address{0x1005, 0}>(+[](uint32_t val) {
-		// Sync producing is unsupported
-		if ((val & 0x40000000) != 0) return SdoErrorCode::UnsupportedAccess;
-
 		// Check if extended flag is set correctly
 		uint32_t newId = (val & 0x1FFFFFFFu);
 		if ((newId & 0x1FFFF800) != 0 && (val & 0x20000000u) == 0)
 			return SdoErrorCode::InvalidValue;
 		syncCobId_ = newId;
+		syncProducer_ = (val & 0x40000000u) != 0;
+		syncProductionStarted_ = false;
 		return SdoErrorCode::NoError;
 	});
 
@@ -456,6 +655,8 @@ CanopenDevice<OD, Protocols...>::registerHandlers() -> HandlerMap<OD>
 		+[]() { return (uint32_t)syncPeriod_.count(); });
 	handlers.template setWriteHandler<Address{0x1006, 0}>(+[](uint32_t val) {
 		syncPeriod_ = std::chrono::microseconds(val);
+		syncPll_.reset(syncPeriod_);
+		syncProductionStarted_ = false;
 		return SdoErrorCode::NoError;
 	});
 
@@ -498,13 +699,16 @@ CanopenDevice<OD, Protocols...>::registerHandlers() -> HandlerMap<OD>
 	handlers.template setWriteHandler<Address{0x1019, 0}>(+[](uint8_t val) {
 		if (val == 1 || val > 240) return SdoErrorCode::InvalidValue;
 		syncCounterOverflow_ = val;
+		producedSyncCounter_ = 0;
 		return SdoErrorCode::NoError;
 	});
 
 	Heartbeat<CanopenDevice>{}.registerHandlers(handlers);
+	TimeConsumer<CanopenDevice>{}.registerHandlers(handlers);
 	ReceivePdoConfigurator<CanopenDevice>{}.registerHandlers(handlers);
 	TransmitPdoConfigurator<CanopenDevice>{}.registerHandlers(handlers);
 	SdoServer<CanopenDevice>{}.registerHandlers(handlers);
+	ParameterStorage<CanopenDevice>{}.registerHandlers(handlers);
 	(Protocols{}.registerHandlers(handlers), ...);
 
 	return handlers;
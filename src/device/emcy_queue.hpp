@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include "../emcy_error.hpp"
+
+namespace modm_canopen
+{
+
+/// Content of one EMCY message, captured when the error is raised
+struct EmcyEntry
+{
+	EMCYError error;
+	uint8_t errorRegister;
+	std::array<uint8_t, 5> manufacturerError;
+};
+
+/// Bounded lock-free queue of pending EMCY messages. Any number of producers (interrupts, control
+/// loop) may push, only update() pops. Pushing to a full queue drops the entry and counts it.
+template<std::size_t Capacity>
+class EmcyQueue
+{
+public:
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+				  "Capacity must be a power of two");
+
+	bool
+	push(const EmcyEntry& entry)
+	{
+		std::size_t position = tail_.load(std::memory_order_relaxed);
+		while (true)
+		{
+			const std::size_t index = position % Capacity;
+			Cell& cell = cells_[index];
+			const std::size_t sequence = cell.sequence.load(std::memory_order_acquire) + index;
+			const auto difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+			if (difference == 0)
+			{
+				// Claim the cell, on failure position holds the current tail
+				if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					cell.entry = entry;
+					cell.sequence.store(position + 1 - index, std::memory_order_release);
+					return true;
+				}
+			} else if (difference < 0)
+			{
+				overflows_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			} else
+			{
+				position = tail_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// Single consumer only
+	std::optional<EmcyEntry>
+	pop()
+	{
+		const std::size_t index = head_ % Capacity;
+		Cell& cell = cells_[index];
+		if (cell.sequence.load(std::memory_order_acquire) + index != head_ + 1) return {};
+		const EmcyEntry entry = cell.entry;
+		cell.sequence.store(head_ + Capacity - index, std::memory_order_release);
+		++head_;
+		return entry;
+	}
+
+	bool
+	empty() const
+	{
+		const std::size_t index = head_ % Capacity;
+		return cells_[index].sequence.load(std::memory_order_acquire) + index != head_ + 1;
+	}
+
+	/// Entries dropped because the queue was full
+	uint32_t
+	overflows() const
+	{
+		return overflows_.load(std::memory_order_relaxed);
+	}
+
+private:
+	// Sequence numbers are stored minus the cell index, so a zero initialized queue is empty and
+	// needs no constructor
+	struct Cell
+	{
+		std::atomic<std::size_t> sequence{0};
+		EmcyEntry entry{};
+	};
+
+	std::array<Cell, Capacity> cells_{};
+	std::atomic<std::size_t> tail_{0};
+	std::size_t head_{0};
+	std::atomic<uint32_t> overflows_{0};
+};
+
+}  // namespace modm_canopen
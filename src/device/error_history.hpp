@@ -0,0 +1,65 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "../object_dictionary.hpp"
+
+namespace modm_canopen
+{
+
+/// Pre-defined error field (0x1003), newest error first. Adding an error is O(1), lock-free and
+/// does not allocate, so errors can be recorded from interrupt handlers.
+template<std::size_t Capacity>
+class ErrorHistory
+{
+public:
+	static_assert(Capacity > 0 && Capacity < 255, "0x1003 supports 1 to 254 errors");
+
+	void
+	add(uint32_t error)
+	{
+		const uint32_t position = added_.fetch_add(1, std::memory_order_relaxed);
+		errors_[position % Capacity].store(error, std::memory_order_release);
+	}
+
+	void
+	clear()
+	{
+		cleared_.store(added_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	uint8_t
+	size() const
+	{
+		const uint32_t count =
+			added_.load(std::memory_order_relaxed) - cleared_.load(std::memory_order_relaxed);
+		return uint8_t(std::min<uint32_t>(count, Capacity));
+	}
+
+	/// Index 0 is the newest error, entries beyond size() read as 0
+	uint32_t
+	operator[](std::size_t index) const
+	{
+		if (index >= size()) return 0;
+		const uint32_t position = added_.load(std::memory_order_relaxed) - 1 - index;
+		return errors_[position % Capacity].load(std::memory_order_acquire);
+	}
+
+private:
+	std::array<std::atomic<uint32_t>, Capacity> errors_{};
+	// Both counters wrap, only their difference matters
+	std::atomic<uint32_t> added_{0};
+	std::atomic<uint32_t> cleared_{0};
+};
+
+/// Number of standard error fields (0x1003 sub 1..N) in the OD
+template<typename OD>
+constexpr std::size_t
+errorHistoryCapacity()
+{
+	return std::max<std::size_t>(subEntryCount<OD>(0x1003), 1);
+}
+
+}  // namespace modm_canopen
@@ -41,6 +41,13 @@ public:
 
 	constexpr HandlerMap() {}
 
+	/// For handlers of optional objects: if constexpr (Map::hasEntry(Address{...}))
+	static constexpr bool
+	hasEntry(Address address)
+	{
+		return static_cast<bool>(OD::map.lookup(address));
+	}
+
 private:
 	static constexpr auto
 	makeReadHandlerMap() -> ReadHandlerMap
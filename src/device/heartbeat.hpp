@@ -1,10 +1,16 @@
 #ifndef CANOPEN_HEARTBEAT_HPP
 #define CANOPEN_HEARTBEAT_HPP
 #include <modm/architecture/interface/can_message.hpp>
+#include <array>
 #include <cstdint>
+#include <type_traits>
+#include <utility>
 #include <modm/processing/timer.hpp>
 #include <modm/debug/logger.hpp>
 
+#include "../next_deadline.hpp"
+#include "../object_dictionary.hpp"
+
 using namespace std::chrono_literals;
 
 namespace modm_canopen
@@ -27,15 +33,34 @@ class Heartbeat
 {
 
 private:
-	static inline bool heartbeatMissed_{false};
 	static inline bool firstUpdate_{true};
 	static inline modm::PreciseClock::time_point lastUpdate_{};
 
 	static inline modm::PreciseClock::duration heartbeatProducerTime_{0ms};
 
-	static inline uint8_t expectedHeartbeatNodeId_{0};
-	static inline modm::PreciseClock::duration heartbeatConsumerTime_{0ms};
-	static inline modm::PreciseClock::time_point lastHeartbeatTime_{};
+	struct Consumer
+	{
+		uint8_t nodeId{0};
+		std::chrono::milliseconds time{0};
+		modm::PreciseClock::time_point deadline{};
+		bool missed{false};
+	};
+
+	// One consumer per 0x1016 sub-entry
+	static constexpr std::size_t ConsumerCount =
+		subEntryCount<typename Device::ObjectDictionary>(0x1016);
+	static_assert(ConsumerCount > 0 && ConsumerCount <= 127, "0x1016 supports 1 to 127 entries");
+
+	static inline std::array<Consumer, ConsumerCount> consumers_{};
+	// Consumers with missed set, only changed through setMissed()
+	static inline uint8_t missedCount_{0};
+	// Node id to consumer index + 1, 0 if the node is not monitored
+	static inline std::array<uint8_t, 128> consumerOfNode_{};
+	// Min-heap of consumers that received a heartbeat, ordered by deadline
+	static inline std::array<uint8_t, ConsumerCount> heap_{};
+	// Consumer to heap position + 1, 0 if it is not in the heap
+	static inline std::array<uint8_t, ConsumerCount> heapPosition_{};
+	static inline uint8_t heapSize_{0};
 
 public:
 	template<typename MessageCallback>
@@ -63,14 +88,30 @@ public:
 			}
 		}
 
-		if (heartbeatConsumerTime_ != 0ms && lastHeartbeatTime_.time_since_epoch().count() != 0)
+		// Only the earliest deadline has to be checked, a missed node is monitored again after its
+		// next heartbeat
+		while (heapSize_ != 0 && isBefore(consumers_[heap_[0]].deadline, now))
 		{
-			if (now - lastHeartbeatTime_ > heartbeatConsumerTime_)
-			{
-				Device::setError(EMCYError::HeartbeartOrGuardingError);
-				heartbeatMissed_ = true;
-			}
+			setMissed(consumers_[heap_[0]], true);
+			removeFromHeap(heap_[0]);
+			Device::setError(EMCYError::HeartbeartOrGuardingError);
+		}
+	}
+
+	static void
+	addDeadlines(NextDeadline &deadline)
+	{
+		constexpr modm::PreciseClock::duration Tick{1};
+		if (firstUpdate_)
+		{
+			deadline.addNow();
+			return;
+		}
+		if (heartbeatProducerTime_ != 0ms)
+		{
+			deadline.add(lastUpdate_ + heartbeatProducerTime_ + Tick);
 		}
+		if (heapSize_ != 0) { deadline.add(consumers_[heap_[0]].deadline + Tick); }
 	}
 
 	template<typename MessageCallback>
@@ -88,17 +129,20 @@ public:
 			cb(msg);
 		}
 
-		if (message.getIdentifier() == 0x700u + expectedHeartbeatNodeId_)
+		const auto identifier = message.getIdentifier();
+		if (identifier < 0x700u || identifier >= 0x780u) return;
+		const uint8_t consumer = consumerOfNode_[identifier - 0x700u];
+		if (consumer == 0 || message.isRemoteTransmitRequest()) return;
+		if (message.getLength() != 1)
 		{
-			if (message.getLength() != 1)
-			{
-				// Invalid length!
-				Device::setError(EMCYError::HeartbeartOrGuardingError);
-			} else
-			{
-				lastHeartbeatTime_ = modm::PreciseClock::now();
-				heartbeatMissed_ = false;
-			}
+			// Invalid length!
+			Device::setError(EMCYError::HeartbeartOrGuardingError);
+		} else
+		{
+			auto &entry = consumers_[consumer - 1];
+			entry.deadline = modm::PreciseClock::now() + entry.time;
+			setMissed(entry, false);
+			updateHeap(consumer - 1);
 		}
 	}
 
@@ -114,29 +158,157 @@ public:
 			return SdoErrorCode::NoError;
 		});
 
-		map.template setReadHandler<Address{0x1016, 0}>(+[]() { return (uint32_t)1; });
-		map.template setReadHandler<Address{0x1016, 1}>(+[]() {
-			return (((uint32_t)heartbeatConsumerTime_.count()) & 0xFFFF) |
-				   (((uint32_t)expectedHeartbeatNodeId_) << 16);
-		});
-
-		map.template setWriteHandler<Address{0x1016, 1}>(+[](uint32_t value) {
-			heartbeatConsumerTime_ = std::chrono::milliseconds(value & 0xFFFF);
-			expectedHeartbeatNodeId_ = (value >> 16) & 0xFF;
-			return SdoErrorCode::NoError;
-		});
+		map.template setReadHandler<Address{0x1016, 0}>(+[]() { return (uint32_t)ConsumerCount; });
+		[&map]<std::size_t... Consumers>(std::index_sequence<Consumers...>) {
+			(registerConsumerHandlers<Consumers>(map), ...);
+		}(std::make_index_sequence<ConsumerCount>{});
 	}
 
 	static bool
 	hasMissedHeartbeat()
 	{
-		return heartbeatMissed_;
+		return missedCount_ != 0;
+	}
+
+	static bool
+	hasMissedHeartbeat(uint8_t nodeId)
+	{
+		const uint8_t consumer = consumerOfNode_[nodeId & 0x7F];
+		return consumer != 0 && consumers_[consumer - 1].missed;
 	}
 
 	static void
 	resetHeartbeatMissed()
 	{
-		heartbeatMissed_ = false;
+		for (auto &consumer : consumers_) { consumer.missed = false; }
+		missedCount_ = 0;
+	}
+
+private:
+	static void
+	setMissed(Consumer &consumer, bool missed)
+	{
+		if (consumer.missed == missed) return;
+		consumer.missed = missed;
+		if (missed)
+		{
+			++missedCount_;
+		} else
+		{
+			--missedCount_;
+		}
+	}
+
+	template<std::size_t Index>
+	static constexpr void
+	registerConsumerHandlers(Device::Map &map)
+	{
+		map.template setReadHandler<Address{0x1016, Index + 1}>(+[]() {
+			const auto &consumer = consumers_[Index];
+			return ((uint32_t)consumer.time.count() & 0xFFFF) | ((uint32_t)consumer.nodeId << 16);
+		});
+		map.template setWriteHandler<Address{0x1016, Index + 1}>(+[](uint32_t value) {
+			return setConsumer(Index, (value >> 16) & 0xFF, value & 0xFFFF);
+		});
+	}
+
+	static SdoErrorCode
+	setConsumer(std::size_t index, uint8_t nodeId, uint16_t time)
+	{
+		const bool enabled = (time != 0 && nodeId != 0 && nodeId <= 127);
+		// Each node may only be monitored by one entry
+		if (enabled && consumerOfNode_[nodeId] != 0 && consumerOfNode_[nodeId] != index + 1)
+		{
+			return SdoErrorCode::GeneralParameterIncompatibility;
+		}
+
+		auto &consumer = consumers_[index];
+		if (consumer.nodeId != 0 && consumer.nodeId <= 127 &&
+			consumerOfNode_[consumer.nodeId] == index + 1)
+		{
+			consumerOfNode_[consumer.nodeId] = 0;
+		}
+		if (heapPosition_[index] != 0) { removeFromHeap(index); }
+		setMissed(consumer, false);
+		consumer = Consumer{.nodeId = nodeId, .time = std::chrono::milliseconds{time}};
+		// Monitoring starts with the first heartbeat received
+		if (enabled) { consumerOfNode_[nodeId] = index + 1; }
+		return SdoErrorCode::NoError;
+	}
+
+	// Deadlines are at most 65 s apart, comparing their difference stays valid across wrap-arounds
+	static bool
+	isBefore(modm::PreciseClock::time_point a, modm::PreciseClock::time_point b)
+	{
+		using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+		return SignedRep((a - b).count()) < 0;
+	}
+
+	static bool
+	heapLess(std::size_t a, std::size_t b)
+	{
+		return isBefore(consumers_[heap_[a]].deadline, consumers_[heap_[b]].deadline);
+	}
+
+	static void
+	heapSwap(std::size_t a, std::size_t b)
+	{
+		std::swap(heap_[a], heap_[b]);
+		heapPosition_[heap_[a]] = a + 1;
+		heapPosition_[heap_[b]] = b + 1;
+	}
+
+	static void
+	siftUp(std::size_t position)
+	{
+		while (position > 0 && heapLess(position, (position - 1) / 2))
+		{
+			heapSwap(position, (position - 1) / 2);
+			position = (position - 1) / 2;
+		}
+	}
+
+	static void
+	siftDown(std::size_t position)
+	{
+		while (true)
+		{
+			std::size_t smallest = position;
+			for (const std::size_t child : {2 * position + 1, 2 * position + 2})
+			{
+				if (child < heapSize_ && heapLess(child, smallest)) { smallest = child; }
+			}
+			if (smallest == position) return;
+			heapSwap(position, smallest);
+			position = smallest;
+		}
+	}
+
+	/// Inserts the consumer or moves it to the position matching its new deadline
+	static void
+	updateHeap(std::size_t consumer)
+	{
+		if (heapPosition_[consumer] == 0)
+		{
+			heap_[heapSize_] = consumer;
+			heapPosition_[consumer] = ++heapSize_;
+		}
+		siftUp(heapPosition_[consumer] - 1);
+		siftDown(heapPosition_[consumer] - 1);
+	}
+
+	static void
+	removeFromHeap(std::size_t consumer)
+	{
+		const std::size_t position = heapPosition_[consumer] - 1;
+		heapSwap(position, --heapSize_);
+		heapPosition_[consumer] = 0;
+		if (position < heapSize_)
+		{
+			const auto moved = heap_[position];
+			siftUp(position);
+			siftDown(heapPosition_[moved] - 1);
+		}
 	}
 };
 
@@ -0,0 +1,310 @@
+#ifndef CANOPEN_LSS_SLAVE_HPP
+#define CANOPEN_LSS_SLAVE_HPP
+#include <modm/architecture/interface/can_message.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "../lss_command.hpp"
+
+namespace modm_canopen
+{
+
+namespace detail
+{
+
+inline void
+makeLssResponse(LSSCommand command, modm::can::Message &message)
+{
+	message = modm::can::Message{LssSlaveCobId, 8};
+	message.setExtended(false);
+	std::fill(message.data, message.data + 8, 0);
+	message.data[0] = (uint8_t)command;
+}
+
+inline uint32_t
+lssValue(const modm::can::Message &message)
+{
+	return message.data[1] | (message.data[2] << 8) | (message.data[3] << 16) |
+		   (uint32_t(message.data[4]) << 24);
+}
+
+}  // namespace detail
+
+/// CiA 305 LSS slave. A device initialized with LssUnconfiguredNodeId only takes part in LSS
+/// until a node id was assigned.
+template<typename Device>
+class LssSlave
+{
+public:
+	enum class Mode : uint8_t
+	{
+		Waiting,
+		Configuration,
+	};
+
+	/// Returns false if the bit timing is not supported
+	using ConfigureBitTimingCallback = bool (*)(uint8_t tableSelector, uint8_t tableIndex);
+	/// The new bit timing has to be activated after the switch delay
+	using ActivateBitTimingCallback = void (*)(uint16_t switchDelay_ms);
+	/// Persists the pending node id and bit timing, returns false on failure
+	using StoreConfigurationCallback = bool (*)(uint8_t nodeId);
+
+	static void
+	setConfigureBitTimingCallback(ConfigureBitTimingCallback callback)
+	{
+		configureBitTiming_ = callback;
+	}
+
+	static void
+	setActivateBitTimingCallback(ActivateBitTimingCallback callback)
+	{
+		activateBitTiming_ = callback;
+	}
+
+	static void
+	setStoreConfigurationCallback(StoreConfigurationCallback callback)
+	{
+		storeConfiguration_ = callback;
+	}
+
+	static Mode
+	mode()
+	{
+		return mode_;
+	}
+
+	/// Node id configured via LSS, becomes active on the next communication reset
+	static uint8_t
+	pendingNodeId()
+	{
+		return pendingNodeId_;
+	}
+
+	static void
+	applyPendingNodeId()
+	{
+		if (!hasPendingNodeId_) return;
+		hasPendingNodeId_ = false;
+		if (pendingNodeId_ != Device::nodeId()) { Device::setNodeId(pendingNodeId_); }
+	}
+
+	/// Returns true if the message was an LSS request
+	template<typename MessageCallback>
+	static bool
+	processMessage(const modm::can::Message &message, MessageCallback &&cb)
+	{
+		if (message.getIdentifier() != LssMasterCobId || message.getLength() != 8) return false;
+
+		const auto &identity = Device::identity();
+		const LssAddress address{identity.vendorId_, identity.productCode_, identity.revisionId_,
+								 identity.serialNumber_};
+		const uint32_t value = detail::lssValue(message);
+		const auto command = (LSSCommand)message.data[0];
+
+		modm::can::Message response{};
+		switch (command)
+		{
+			case LSSCommand::SwitchStateGlobal:
+				if (message.data[1] == 0)
+				{
+					mode_ = Mode::Waiting;
+					// The first node id of an unconfigured device is activated right away
+					if (!Device::isConfigured()) { applyPendingNodeId(); }
+				} else if (message.data[1] == 1)
+				{
+					mode_ = Mode::Configuration;
+				}
+				selectiveStep_ = 0;
+				fastScanPosition_ = 0;
+				return true;
+			case LSSCommand::SwitchStateSelectiveVendor:
+			case LSSCommand::SwitchStateSelectiveProduct:
+			case LSSCommand::SwitchStateSelectiveRevision:
+			case LSSCommand::SwitchStateSelectiveSerial: {
+				const uint8_t step =
+					message.data[0] - (uint8_t)LSSCommand::SwitchStateSelectiveVendor;
+				// The vendor always starts a new sequence, an interrupted one is dropped
+				if (step == 0) { selectiveStep_ = 0; }
+				if (step != selectiveStep_ || value != address[step])
+				{
+					selectiveStep_ = 0;
+					return true;
+				}
+				if (++selectiveStep_ < address.size()) return true;
+				selectiveStep_ = 0;
+				mode_ = Mode::Configuration;
+				detail::makeLssResponse(LSSCommand::SwitchStateSelectiveResponse, response);
+				cb(response);
+				return true;
+			}
+			case LSSCommand::IdentifyRemoteVendor:
+			case LSSCommand::IdentifyRemoteProduct:
+			case LSSCommand::IdentifyRemoteRevisionLow:
+			case LSSCommand::IdentifyRemoteRevisionHigh:
+			case LSSCommand::IdentifyRemoteSerialLow:
+			case LSSCommand::IdentifyRemoteSerialHigh: {
+				const uint8_t step = message.data[0] - (uint8_t)LSSCommand::IdentifyRemoteVendor;
+				if (step == 0)
+				{
+					identifyMatch_ = true;
+					identifyStep_ = 0;
+				}
+				if (step != identifyStep_)
+				{
+					identifyStep_ = 0;
+					return true;
+				}
+				// Vendor and product have to be equal, revision and serial within [low, high]
+				constexpr std::array<uint8_t, 6> field{0, 1, 2, 2, 3, 3};
+				const uint32_t own = address[field[step]];
+				const bool isLow = step == 2 || step == 4;
+				const bool matches =
+					(step < 2) ? (own == value) : (isLow ? (own >= value) : (own <= value));
+				identifyMatch_ = identifyMatch_ && matches;
+
+				identifyStep_ = (step + 1) % 6;
+				if (identifyStep_ == 0 && identifyMatch_)
+				{
+					detail::makeLssResponse(LSSCommand::IdentifySlave, response);
+					cb(response);
+				}
+				return true;
+			}
+			case LSSCommand::IdentifyNonConfiguredRemote:
+				if (!Device::isConfigured())
+				{
+					detail::makeLssResponse(LSSCommand::IdentifyNonConfiguredSlave, response);
+					cb(response);
+				}
+				return true;
+			case LSSCommand::FastScan:
+				handleFastScan(message, address, std::forward<MessageCallback>(cb));
+				return true;
+			default:
+				break;
+		}
+
+		if (mode_ != Mode::Configuration) return true;
+
+		switch (command)
+		{
+			case LSSCommand::ConfigureNodeId: {
+				const uint8_t nodeId = message.data[1];
+				const bool valid =
+					(nodeId >= 1 && nodeId <= 127) || nodeId == LssUnconfiguredNodeId;
+				if (valid)
+				{
+					pendingNodeId_ = nodeId;
+					hasPendingNodeId_ = true;
+				}
+				detail::makeLssResponse(command, response);
+				response.data[1] = valid ? 0 : 1;  // 1: node id out of range
+				cb(response);
+				break;
+			}
+			case LSSCommand::ConfigureBitTiming: {
+				const bool supported =
+					configureBitTiming_ && configureBitTiming_(message.data[1], message.data[2]);
+				detail::makeLssResponse(command, response);
+				response.data[1] = supported ? 0 : 1;  // 1: bit timing not supported
+				cb(response);
+				break;
+			}
+			case LSSCommand::ActivateBitTiming:
+				if (activateBitTiming_)
+				{
+					activateBitTiming_(message.data[1] | (message.data[2] << 8));
+				}
+				break;
+			case LSSCommand::StoreConfiguration: {
+				detail::makeLssResponse(command, response);
+				// 1: store not supported, 2: storage media access error
+				if (!storeConfiguration_)
+				{
+					response.data[1] = 1;
+				} else if (!storeConfiguration_(pendingNodeId_))
+				{
+					response.data[1] = 2;
+				}
+				cb(response);
+				break;
+			}
+			case LSSCommand::InquireVendor:
+			case LSSCommand::InquireProduct:
+			case LSSCommand::InquireRevision:
+			case LSSCommand::InquireSerial: {
+				const uint8_t field = message.data[0] - (uint8_t)LSSCommand::InquireVendor;
+				const uint32_t own = address[field];
+				detail::makeLssResponse(command, response);
+				response.data[1] = own & 0xFF;
+				response.data[2] = (own >> 8) & 0xFF;
+				response.data[3] = (own >> 16) & 0xFF;
+				response.data[4] = (own >> 24) & 0xFF;
+				cb(response);
+				break;
+			}
+			case LSSCommand::InquireNodeId:
+				detail::makeLssResponse(command, response);
+				response.data[1] = Device::nodeId();
+				cb(response);
+				break;
+			default:
+				break;
+		}
+		return true;
+	}
+
+private:
+	static inline Mode mode_{Mode::Waiting};
+	static inline uint8_t pendingNodeId_{LssUnconfiguredNodeId};
+	static inline bool hasPendingNodeId_{false};
+	static inline uint8_t selectiveStep_{0};
+	static inline uint8_t identifyStep_{0};
+	static inline bool identifyMatch_{false};
+	static inline uint8_t fastScanPosition_{0};
+
+	static inline ConfigureBitTimingCallback configureBitTiming_{nullptr};
+	static inline ActivateBitTimingCallback activateBitTiming_{nullptr};
+	static inline StoreConfigurationCallback storeConfiguration_{nullptr};
+
+	template<typename MessageCallback>
+	static void
+	handleFastScan(const modm::can::Message &message, const LssAddress &address,
+				   MessageCallback &&cb)
+	{
+		// Only unconfigured slaves in waiting state take part
+		if (mode_ != Mode::Waiting || Device::isConfigured()) return;
+
+		const uint32_t idNumber = detail::lssValue(message);
+		const uint8_t bitChecked = message.data[5];
+		const uint8_t lssSub = message.data[6];
+		const uint8_t lssNext = message.data[7];
+
+		modm::can::Message response{};
+		if (bitChecked == LssFastScanReset)
+		{
+			fastScanPosition_ = 0;
+			detail::makeLssResponse(LSSCommand::IdentifySlave, response);
+			cb(response);
+			return;
+		}
+		if (bitChecked > 31 || lssSub != fastScanPosition_ || lssSub >= address.size()) return;
+
+		// Bits below bitChecked are not determined by the master yet
+		const uint32_t mask = ~((uint32_t(1) << bitChecked) - 1);
+		if (((idNumber ^ address[lssSub]) & mask) != 0) return;
+
+		detail::makeLssResponse(LSSCommand::IdentifySlave, response);
+		cb(response);
+		if (bitChecked == 0)
+		{
+			// Wrapping around to an earlier part means the whole address was confirmed
+			if (lssNext < fastScanPosition_) { mode_ = Mode::Configuration; }
+			fastScanPosition_ = lssNext;
+		}
+	}
+};
+
+}  // namespace modm_canopen
+#endif
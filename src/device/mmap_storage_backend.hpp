@@ -0,0 +1,87 @@
+#ifndef CANOPEN_MMAP_STORAGE_BACKEND_HPP
+#define CANOPEN_MMAP_STORAGE_BACKEND_HPP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+
+#include "storage_backend.hpp"
+
+namespace modm_canopen
+{
+
+/// Parameter storage in a memory mapped file, for devices running on Linux
+class MmapStorageBackend : public StorageBackend
+{
+public:
+	/// The file is created or grown to capacity if required, a new file holds no valid image
+	MmapStorageBackend(const char* path, std::size_t capacity)
+	{
+		fd_ = ::open(path, O_RDWR | O_CREAT, 0644);
+		if (fd_ < 0) return;
+		struct stat info{};
+		const bool sized =
+			(::fstat(fd_, &info) == 0) &&
+			(std::size_t(info.st_size) >= capacity || ::ftruncate(fd_, capacity) == 0);
+		void* mapping = MAP_FAILED;
+		if (sized)
+		{
+			mapping = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+		}
+		if (mapping == MAP_FAILED)
+		{
+			::close(fd_);
+			fd_ = -1;
+			return;
+		}
+		data_ = static_cast<uint8_t*>(mapping);
+		size_ = capacity;
+	}
+
+	MmapStorageBackend(const MmapStorageBackend&) = delete;
+	MmapStorageBackend&
+	operator=(const MmapStorageBackend&) = delete;
+
+	~MmapStorageBackend() override
+	{
+		if (data_) { ::munmap(data_, size_); }
+		if (fd_ >= 0) { ::close(fd_); }
+	}
+
+	bool
+	isOpen() const
+	{
+		return data_ != nullptr;
+	}
+
+	std::span<const uint8_t>
+	read() override
+	{
+		return {data_, size_};
+	}
+
+	bool
+	write(std::span<const uint8_t> image) override
+	{
+		if (!data_ || image.size() > size_) return false;
+		std::memcpy(data_, image.data(), image.size());
+		return ::msync(data_, size_, MS_SYNC) == 0;
+	}
+
+	bool
+	erase() override
+	{
+		if (!data_) return false;
+		std::memset(data_, 0, size_);
+		return ::msync(data_, size_, MS_SYNC) == 0;
+	}
+
+private:
+	int fd_{-1};
+	uint8_t* data_{nullptr};
+	std::size_t size_{0};
+};
+
+}  // namespace modm_canopen
+#endif
@@ -0,0 +1,365 @@
+#ifndef CANOPEN_PARAMETER_STORAGE_HPP
+#define CANOPEN_PARAMETER_STORAGE_HPP
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <variant>
+
+#include "../object_dictionary.hpp"
+#include "../sdo_error.hpp"
+#include "storage_backend.hpp"
+
+namespace modm_canopen
+{
+
+/// Parameter groups of 0x1010/0x1011, sub-index 1 selects all of them
+enum class ParameterGroup : uint8_t
+{
+	Communication = 0x01,  // 0x1000 - 0x1FFF
+	Application = 0x02,    // 0x6000 - 0x9FFF and above
+	Manufacturer = 0x04,   // 0x2000 - 0x5FFF
+	All = 0x07,
+};
+
+namespace detail
+{
+
+/// CRC-32 (IEEE 802.3) with a nibble table, small enough for MCUs
+class Crc32
+{
+public:
+	constexpr void
+	update(std::span<const uint8_t> data)
+	{
+		constexpr std::array<uint32_t, 16> table{
+			0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+			0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+			0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+		for (const uint8_t byte : data)
+		{
+			state_ = table[(state_ ^ byte) & 0x0F] ^ (state_ >> 4);
+			state_ = table[(state_ ^ (byte >> 4)) & 0x0F] ^ (state_ >> 4);
+		}
+	}
+
+	constexpr uint32_t
+	value() const
+	{
+		return ~state_;
+	}
+
+private:
+	uint32_t state_{0xFFFF'FFFF};
+};
+
+}  // namespace detail
+
+/// Store (0x1010) and restore default (0x1011) parameters. Values of all readable and writable
+/// objects except the process data of the protocols (CanopenDevice::isProcessData()) are kept in
+/// one image: a header followed by the raw values in a fixed order derived from the OD at compile
+/// time, so no addresses are stored and loading is a single pass. The image is rejected if the OD
+/// layout or the format version changed or the CRC does not match.
+template<typename Device>
+class ParameterStorage
+{
+public:
+	static constexpr uint32_t SaveSignature = 0x6576'6173;  // "save"
+	static constexpr uint32_t LoadSignature = 0x6461'6F6C;  // "load"
+
+	static void
+	setBackend(StorageBackend* backend)
+	{
+		backend_ = backend;
+	}
+
+	/// Bytes the backend has to provide
+	static constexpr std::size_t
+	requiredCapacity()
+	{
+		return BufferSize;
+	}
+
+	/// Stores the current values of group, other groups keep their stored values
+	static SdoErrorCode
+	store(ParameterGroup group)
+	{
+		if (!backend_) return SdoErrorCode::HardwareError;
+		const auto previous = validImage();
+		const uint8_t groups = uint8_t(group);
+		const uint8_t previousGroups = previous ? (*previous)[GroupsOffset] : 0;
+
+		std::size_t offset = HeaderSize;
+		for (const auto& entry : Entries)
+		{
+			const auto target = std::span{buffer_}.subspan(offset, entry.size);
+			if (groups & entry.group)
+			{
+				const auto value = Device::read(entry.address);
+				if (!std::holds_alternative<Value>(value))
+				{
+					return SdoErrorCode::DataCannotBeTransferred;
+				}
+				valueToBytes(std::get<Value>(value), target);
+			} else if (previousGroups & entry.group)
+			{
+				const auto source = previous->subspan(offset, entry.size);
+				std::copy(source.begin(), source.end(), target.begin());
+			} else
+			{
+				std::fill(target.begin(), target.end(), 0);
+			}
+			offset += entry.size;
+		}
+		return writeImage(groups | previousGroups);
+	}
+
+	/// Discards the stored values of group, the defaults apply from the next boot on
+	static SdoErrorCode
+	restoreDefaults(ParameterGroup group)
+	{
+		if (!backend_) return SdoErrorCode::HardwareError;
+		const auto previous = validImage();
+		if (!previous) return SdoErrorCode::NoError;
+
+		const uint8_t groups = (*previous)[GroupsOffset] & ~uint8_t(group);
+		if (groups == 0)
+		{
+			return backend_->erase() ? SdoErrorCode::NoError : SdoErrorCode::HardwareError;
+		}
+		std::copy(previous->begin(), previous->end(), buffer_.begin());
+		return writeImage(groups);
+	}
+
+	/// Writes all stored values to the OD, call once at boot after CanopenDevice::initialize().
+	/// Values rejected by a write handler keep their current value. Returns false without a valid
+	/// image.
+	static bool
+	load()
+	{
+		const auto image = validImage();
+		if (!image) return false;
+		const uint8_t groups = (*image)[GroupsOffset];
+
+		// Mappings can only be changed while a PDO is disabled, the stored COB-IDs come last
+		if (groups & uint8_t(ParameterGroup::Communication))
+		{
+			for (auto& rpdo : Device::receivePdos_) { rpdo.setInactive(); }
+			for (auto& tpdo : Device::transmitPdos_) { tpdo.setInactive(); }
+		}
+
+		std::size_t offset = HeaderSize;
+		for (const auto& entry : Entries)
+		{
+			if (groups & entry.group)
+			{
+				Device::write(entry.address, image->subspan(offset, entry.size), entry.size);
+			}
+			offset += entry.size;
+		}
+		return true;
+	}
+
+	constexpr void
+	registerHandlers(Device::Map& map)
+	{
+		registerCommandObject<0x1010>(map);
+		registerCommandObject<0x1011>(map);
+	}
+
+private:
+	static constexpr uint32_t Magic = 0x5453'5043;  // "CPST"
+	static constexpr uint16_t Version = 1;
+
+	// magic, version, groups, reserved, layout hash, payload size, CRC over all other bytes
+	static constexpr std::size_t GroupsOffset = 6;
+	static constexpr std::size_t CrcOffset = 16;
+	static constexpr std::size_t HeaderSize = 20;
+
+	struct StoredEntry
+	{
+		Address address;
+		uint8_t size;
+		uint8_t group;
+	};
+
+	static constexpr bool
+	isStored(const Entry& entry)
+	{
+		const auto index = entry.address.index;
+		// Process data like the controlword must not be restored at boot, error history and
+		// store/restore commands are not parameters either
+		return entry.isReadable() && entry.isWritable() && entry.dataType != DataType::Empty &&
+			   index != 0x1003 && index != 0x1010 && index != 0x1011 &&
+			   !Device::isProcessData(entry.address);
+	}
+
+	// Position in the image: PDO mapping counts are only accepted after the mappings were written
+	// and PDOs are enabled by writing their COB-IDs, so both are moved behind all other values
+	static constexpr uint8_t
+	loadPhase(Address address)
+	{
+		const auto index = address.index;
+		const bool mapping =
+			(index >= 0x1600 && index < 0x1800) || (index >= 0x1A00 && index < 0x1C00);
+		const bool communication =
+			(index >= 0x1400 && index < 0x1600) || (index >= 0x1800 && index < 0x1A00);
+		if (mapping && address.subindex == 0) return 1;
+		if (communication && address.subindex == 1) return 2;
+		return 0;
+	}
+
+	static constexpr uint8_t
+	groupOf(Address address)
+	{
+		if (address.index < 0x2000) return uint8_t(ParameterGroup::Communication);
+		if (address.index < 0x6000) return uint8_t(ParameterGroup::Manufacturer);
+		return uint8_t(ParameterGroup::Application);
+	}
+
+	static constexpr std::size_t EntryCount =
+		std::count_if(Device::ObjectDictionary::map.begin(), Device::ObjectDictionary::map.end(),
+					  [](const auto& element) { return isStored(element.second); });
+
+	static constexpr std::array<StoredEntry, EntryCount> Entries = [] {
+		std::array<StoredEntry, EntryCount> entries{};
+		std::size_t position = 0;
+		for (uint8_t phase = 0; phase < 3; ++phase)
+		{
+			for (const auto& [address, entry] : Device::ObjectDictionary::map)
+			{
+				if (!isStored(entry) || loadPhase(address) != phase) continue;
+				entries[position++] = StoredEntry{address, uint8_t(getDataTypeSize(entry.dataType)),
+												  groupOf(address)};
+			}
+		}
+		return entries;
+	}();
+
+	static constexpr std::size_t PayloadSize = [] {
+		std::size_t size = 0;
+		for (const auto& entry : Entries) { size += entry.size; }
+		return size;
+	}();
+
+	// FNV-1a over addresses and sizes, identifies the order of values in the payload
+	static constexpr uint32_t LayoutHash = [] {
+		uint32_t hash = 0x811C'9DC5;
+		for (const auto& entry : Entries)
+		{
+			const auto index = entry.address.index;
+			for (const uint8_t byte :
+				 {uint8_t(index), uint8_t(index >> 8), entry.address.subindex, entry.size})
+			{
+				hash = (hash ^ byte) * 0x0100'0193;
+			}
+		}
+		return hash;
+	}();
+
+	static constexpr std::size_t ImageSize = HeaderSize + PayloadSize;
+	// Flash is programmed in double words at most
+	static constexpr std::size_t BufferSize = (ImageSize + 7) / 8 * 8;
+
+	static inline StorageBackend* backend_{nullptr};
+	static inline std::array<uint8_t, BufferSize> buffer_{};
+
+	template<uint16_t Index>
+	constexpr void
+	registerCommandObject(Device::Map& map)
+	{
+		if constexpr (Device::Map::hasEntry(Address{Index, 0}))
+		{
+			constexpr uint8_t highestSubIndex = Device::Map::hasEntry(Address{Index, 4})   ? 4
+												: Device::Map::hasEntry(Address{Index, 3}) ? 3
+												: Device::Map::hasEntry(Address{Index, 2}) ? 2
+																						   : 1;
+			map.template setReadHandler<Address{Index, 0}>(
+				+[]() -> uint8_t { return highestSubIndex; });
+			registerCommand<Index, 1, ParameterGroup::All>(map);
+			registerCommand<Index, 2, ParameterGroup::Communication>(map);
+			registerCommand<Index, 3, ParameterGroup::Application>(map);
+			registerCommand<Index, 4, ParameterGroup::Manufacturer>(map);
+		}
+	}
+
+	template<uint16_t Index, uint8_t SubIndex, ParameterGroup Group>
+	constexpr void
+	registerCommand(Device::Map& map)
+	{
+		if constexpr (Device::Map::hasEntry(Address{Index, SubIndex}))
+		{
+			// Bit 0: the device stores or restores on command
+			map.template setReadHandler<Address{Index, SubIndex}>(
+				+[]() -> uint32_t { return backend_ ? 1 : 0; });
+			map.template setWriteHandler<Address{Index, SubIndex}>(+[](uint32_t signature) {
+				if constexpr (Index == 0x1010)
+				{
+					if (signature != SaveSignature) return SdoErrorCode::DataCannotBeTransferred;
+					return store(Group);
+				} else
+				{
+					if (signature != LoadSignature) return SdoErrorCode::DataCannotBeTransferred;
+					return restoreDefaults(Group);
+				}
+			});
+		}
+	}
+
+	static std::optional<std::span<const uint8_t>>
+	validImage()
+	{
+		if (!backend_) return {};
+		const auto data = backend_->read();
+		if (data.size() < ImageSize) return {};
+		if (load32(data, 0) != Magic || (data[4] | (data[5] << 8)) != Version ||
+			load32(data, 8) != LayoutHash || load32(data, 12) != PayloadSize)
+		{
+			return {};
+		}
+		if (crc(data.first(ImageSize)) != load32(data, CrcOffset)) return {};
+		return data.first(ImageSize);
+	}
+
+	/// Completes the header of the payload in buffer_ and writes it to the backend
+	static SdoErrorCode
+	writeImage(uint8_t groups)
+	{
+		const auto image = std::span{buffer_};
+		store32(image, 0, Magic);
+		image[4] = uint8_t(Version);
+		image[5] = uint8_t(Version >> 8);
+		image[GroupsOffset] = groups;
+		image[7] = 0;
+		store32(image, 8, LayoutHash);
+		store32(image, 12, PayloadSize);
+		store32(image, CrcOffset, crc(image.first(ImageSize)));
+		return backend_->write(image) ? SdoErrorCode::NoError : SdoErrorCode::HardwareError;
+	}
+
+	static uint32_t
+	crc(std::span<const uint8_t> image)
+	{
+		detail::Crc32 crc;
+		crc.update(image.first(CrcOffset));
+		crc.update(image.subspan(HeaderSize));
+		return crc.value();
+	}
+
+	static uint32_t
+	load32(std::span<const uint8_t> data, std::size_t offset)
+	{
+		return data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) |
+			   (uint32_t(data[offset + 3]) << 24);
+	}
+
+	static void
+	store32(std::span<uint8_t> data, std::size_t offset, uint32_t value)
+	{
+		for (std::size_t i = 0; i < 4; ++i) { data[offset + i] = uint8_t(value >> (8 * i)); }
+	}
+};
+
+}  // namespace modm_canopen
+#endif
@@ -0,0 +1,72 @@
+#ifndef CANOPEN_STORAGE_BACKEND_HPP
+#define CANOPEN_STORAGE_BACKEND_HPP
+#include <cstdint>
+#include <span>
+
+namespace modm_canopen
+{
+
+/// Non-volatile memory holding the parameter image of ParameterStorage
+class StorageBackend
+{
+public:
+	virtual ~StorageBackend() = default;
+
+	/// Whole storage area, its content is validated by the caller
+	virtual std::span<const uint8_t>
+	read() = 0;
+
+	/// Replaces the stored image, images larger than the storage area fail
+	virtual bool
+	write(std::span<const uint8_t> image) = 0;
+
+	virtual bool
+	erase() = 0;
+};
+
+/// Memory mapped flash region, usually the last pages of an MCU's flash. Erasing and programming
+/// are left to the platform, the region has to cover whole erasable pages.
+class FlashStorageBackend : public StorageBackend
+{
+public:
+	using EraseFunction = bool (*)(uintptr_t address, std::size_t size);
+	using ProgramFunction = bool (*)(uintptr_t address, std::span<const uint8_t> data);
+
+	FlashStorageBackend(std::span<const uint8_t> region, EraseFunction erase,
+						ProgramFunction program)
+		: region_{region}, erase_{erase}, program_{program}
+	{}
+
+	std::span<const uint8_t>
+	read() override
+	{
+		return region_;
+	}
+
+	bool
+	write(std::span<const uint8_t> image) override
+	{
+		if (image.size() > region_.size()) return false;
+		return erase() && program_(address(), image);
+	}
+
+	bool
+	erase() override
+	{
+		return erase_(address(), region_.size());
+	}
+
+private:
+	uintptr_t
+	address() const
+	{
+		return reinterpret_cast<uintptr_t>(region_.data());
+	}
+
+	std::span<const uint8_t> region_;
+	EraseFunction erase_;
+	ProgramFunction program_;
+};
+
+}  // namespace modm_canopen
+#endif
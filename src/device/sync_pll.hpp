@@ -0,0 +1,270 @@
+#ifndef CANOPEN_SYNC_PLL_HPP
+#define CANOPEN_SYNC_PLL_HPP
+#include <modm/architecture/interface/clock.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <type_traits>
+
+namespace modm_canopen
+{
+
+/// Software PLL locking to the received SYNC. Estimates the SYNC period in local clock time and the
+/// phase of the SYNC from arrival timestamps. Arrivals further off than a multiple of the measured
+/// jitter are rejected as outliers, lost SYNCs are counted from the elapsed time.
+/// With a nominal period the estimate stays within 1/64 of it, without one the first interval is
+/// the initial estimate and the period is tracked freely.
+/// Internally nanoseconds relative to the last accepted SYNC, so wrap-arounds of the PreciseClock
+/// don't matter and the period keeps sub-microsecond resolution.
+class SyncPll
+{
+public:
+	using time_point = modm::PreciseClock::time_point;
+
+	/// Forgets the estimate, the next SYNC starts the acquisition again. A nominal period of 0
+	/// leaves the period to the measurement.
+	void
+	reset(std::chrono::microseconds nominalPeriod)
+	{
+		nominalNs_ = nominalPeriod.count() * 1000;
+		periodNs_ = nominalNs_;
+		started_ = false;
+		hasArrival_ = false;
+		acceptedInRow_ = 0;
+		outliersInRow_ = 0;
+	}
+
+	/// Lower bound of tolerance(), deviations below it are never outliers
+	void
+	setMinimumTolerance(std::chrono::microseconds tolerance)
+	{
+		minimumToleranceNs_ = tolerance.count() * 1000;
+	}
+
+	/// Returns false if the SYNC was rejected as outlier
+	bool
+	update(time_point arrival)
+	{
+		if (!started_)
+		{
+			if (periodNs_ == 0)
+			{
+				// The first interval is the initial estimate
+				const int64_t intervalNs = microseconds(arrival, referenceLocal_) * 1000;
+				const bool first = !hasArrival_;
+				hasArrival_ = true;
+				referenceLocal_ = arrival;
+				if (first || intervalNs <= 0) return true;
+				periodNs_ = intervalNs;
+			}
+			start(arrival, 0);
+			return true;
+		}
+
+		// Error relative to the closest predicted SYNC, lost SYNCs are skipped
+		const int64_t measuredNs = microseconds(arrival, referenceLocal_) * 1000;
+		const int64_t cycles =
+			std::max<int64_t>(1, (measuredNs - phaseNs_ + periodNs_ / 2) / periodNs_);
+		const int64_t predictedNs = phaseNs_ + cycles * periodNs_;
+		const int64_t errorNs = measuredNs - predictedNs;
+		lastErrorNs_ = errorNs;
+
+		const bool acquiring = acceptedInRow_ < AcquisitionCycles;
+		if (!acquiring && std::abs(errorNs) > toleranceNs())
+		{
+			++outliers_;
+			// The master changed its phase, acquire again instead of rejecting everything. A
+			// measured period may have changed as well.
+			if (++outliersInRow_ >= RestartOutliers)
+			{
+				if (nominalNs_ == 0)
+				{
+					reset(std::chrono::microseconds{0});
+					hasArrival_ = true;
+					referenceLocal_ = arrival;
+				} else
+				{
+					start(arrival, cycle_ + cycles);
+				}
+			}
+			return false;
+		}
+		outliersInRow_ = 0;
+
+		// Second order loop, stronger gains while acquiring
+		const int64_t phaseGain = acquiring ? 2 : 8;
+		const int64_t periodGain = acquiring ? 8 : 64;
+		const int64_t estimateNs = predictedNs + errorNs / phaseGain;
+		periodNs_ += errorNs / (periodGain * cycles);
+		if (nominalNs_ != 0)
+		{
+			periodNs_ =
+				std::clamp(periodNs_, nominalNs_ - nominalNs_ / 64, nominalNs_ + nominalNs_ / 64);
+		}
+		jitterNs_ += (std::abs(errorNs) - jitterNs_) / 16;
+
+		referenceLocal_ = arrival;
+		phaseNs_ = estimateNs - measuredNs;
+		cycle_ += cycles;
+		if (acceptedInRow_ < AcquisitionCycles + LockCycles) { ++acceptedInRow_; }
+		return true;
+	}
+
+	bool
+	isStarted() const
+	{
+		return started_;
+	}
+
+	/// The period was given to reset() instead of measured
+	bool
+	hasNominalPeriod() const
+	{
+		return nominalNs_ != 0;
+	}
+
+	bool
+	isLocked() const
+	{
+		return acceptedInRow_ >= AcquisitionCycles + LockCycles;
+	}
+
+	/// Number of the last accepted SYNC, counting lost ones
+	int64_t
+	cycle() const
+	{
+		return cycle_;
+	}
+
+	/// Estimated local time of a SYNC cycle
+	time_point
+	syncTime(int64_t cycle) const
+	{
+		const int64_t offsetNs = phaseNs_ + (cycle - cycle_) * periodNs_;
+		return referenceLocal_ + modm::PreciseClock::duration{floorDivide(offsetNs, 1000)};
+	}
+
+	/// Estimated time of the first SYNC after now
+	time_point
+	nextSync(time_point now) const
+	{
+		return syncTime(cycle_ + cyclesUntil(now) + 1);
+	}
+
+	/// Time since the estimated SYNC before t, in [0, period)
+	std::chrono::nanoseconds
+	syncRelativeTime(time_point t) const
+	{
+		if (!started_) return {};
+		const int64_t offsetNs = microseconds(t, referenceLocal_) * 1000 - phaseNs_;
+		return std::chrono::nanoseconds{offsetNs - floorDivide(offsetNs, periodNs_) * periodNs_};
+	}
+
+	std::chrono::nanoseconds
+	period() const
+	{
+		return std::chrono::nanoseconds{periodNs_};
+	}
+
+	/// Mean absolute deviation of accepted SYNCs from the estimate
+	std::chrono::nanoseconds
+	jitter() const
+	{
+		return std::chrono::nanoseconds{jitterNs_};
+	}
+
+	/// Deviation from the estimate above which a SYNC is an outlier
+	std::chrono::nanoseconds
+	tolerance() const
+	{
+		return std::chrono::nanoseconds{toleranceNs()};
+	}
+
+	/// Deviation of the last SYNC from its predicted time
+	std::chrono::nanoseconds
+	lastError() const
+	{
+		return std::chrono::nanoseconds{lastErrorNs_};
+	}
+
+	uint32_t
+	outliers() const
+	{
+		return outliers_;
+	}
+
+	/// Incremented on every (re)acquisition, the phase may have jumped
+	uint32_t
+	starts() const
+	{
+		return starts_;
+	}
+
+private:
+	static constexpr uint8_t AcquisitionCycles = 8;
+	static constexpr uint8_t LockCycles = 8;
+	static constexpr uint8_t RestartOutliers = 4;
+	// About six standard deviations for normally distributed jitter
+	static constexpr int64_t ToleranceFactor = 8;
+
+	int64_t nominalNs_{0};
+	int64_t periodNs_{0};
+	int64_t minimumToleranceNs_{1'000'000};
+	bool started_{false};
+	// Without a nominal period: referenceLocal_ holds the first arrival
+	bool hasArrival_{false};
+	time_point referenceLocal_{};
+	// Estimated time of SYNC cycle_ relative to referenceLocal_
+	int64_t phaseNs_{0};
+	int64_t cycle_{0};
+	int64_t jitterNs_{0};
+	int64_t lastErrorNs_{0};
+	uint8_t acceptedInRow_{0};
+	uint8_t outliersInRow_{0};
+	uint32_t outliers_{0};
+	uint32_t starts_{0};
+
+	void
+	start(time_point arrival, int64_t cycle)
+	{
+		started_ = true;
+		referenceLocal_ = arrival;
+		phaseNs_ = 0;
+		cycle_ = cycle;
+		jitterNs_ = 0;
+		acceptedInRow_ = 0;
+		outliersInRow_ = 0;
+		++starts_;
+	}
+
+	int64_t
+	toleranceNs() const
+	{
+		return std::max(ToleranceFactor * jitterNs_, minimumToleranceNs_);
+	}
+
+	int64_t
+	cyclesUntil(time_point now) const
+	{
+		const int64_t offsetNs = microseconds(now, referenceLocal_) * 1000 - phaseNs_;
+		return floorDivide(offsetNs, periodNs_);
+	}
+
+	static int64_t
+	microseconds(time_point a, time_point b)
+	{
+		using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+		return SignedRep((a - b).count());
+	}
+
+	static int64_t
+	floorDivide(int64_t value, int64_t divisor)
+	{
+		const int64_t quotient = value / divisor;
+		return (value % divisor < 0) ? quotient - 1 : quotient;
+	}
+};
+
+}  // namespace modm_canopen
+#endif
@@ -0,0 +1,156 @@
+#ifndef CANOPEN_SYNC_SCHEDULER_HPP
+#define CANOPEN_SYNC_SCHEDULER_HPP
+#include <modm/processing/timer.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "../next_deadline.hpp"
+#include "sync_pll.hpp"
+
+namespace modm_canopen
+{
+
+/// Runs cyclic tasks phase-locked to the received SYNC. Each task runs every divider-th SYNC cycle
+/// at a fixed offset to the SYNC. With a negative offset the task runs before the predicted SYNC,
+/// so its results are sampled by the synchronous TPDOs sent right after it.
+/// Between SYNCs the schedule follows the period estimated by the device's SyncPll, so it keeps
+/// running through a lost SYNC.
+template<typename Device>
+class SyncScheduler
+{
+public:
+	using Task = void (*)();
+	static constexpr std::size_t MaxTasks = 8;
+	static constexpr int32_t MaxLostSyncs = 2;
+
+	/// Returns false if all task slots are taken
+	static bool
+	addTask(Task task, std::chrono::microseconds offset, uint8_t divider = 1)
+	{
+		if (!task || divider == 0 || taskCount_ == MaxTasks) return false;
+		tasks_[taskCount_++] = ScheduledTask{task, offset, divider, 0};
+		if (pll().isStarted() && pll().starts() == seenStarts_)
+		{
+			scheduleFirstRun(tasks_[taskCount_ - 1], modm::PreciseClock::now());
+		}
+		return true;
+	}
+
+	static void
+	removeTask(Task task)
+	{
+		const auto end = std::remove_if(tasks_.begin(), tasks_.begin() + taskCount_,
+										[task](const auto& entry) { return entry.task == task; });
+		taskCount_ = end - tasks_.begin();
+	}
+
+	/// Estimated time of the SYNC with the given cycle number relative to the last one
+	static modm::PreciseClock::time_point
+	syncTime(int32_t cycles = 1)
+	{
+		return pll().syncTime(pll().cycle() + cycles);
+	}
+
+	static std::chrono::nanoseconds
+	period()
+	{
+		return pll().period();
+	}
+
+	/// The last SYNCs arrived close to their predicted time
+	static bool
+	isLocked()
+	{
+		return pll().isLocked();
+	}
+
+	/// Locked and no more than MaxLostSyncs SYNCs missing since the last one. Tasks with a
+	/// schedule of their own fall back to it otherwise.
+	static bool
+	isActive()
+	{
+		return pll().isLocked() &&
+			   signedDifference(modm::PreciseClock::now(), syncTime(MaxLostSyncs + 1)) < 0;
+	}
+
+	/// Runs due tasks and adds the next task deadline
+	static void
+	update(NextDeadline& deadline)
+	{
+		if (!pll().isStarted()) return;
+		const auto now = modm::PreciseClock::now();
+		// The phase jumps when the PLL acquires the SYNC again
+		if (pll().starts() != seenStarts_)
+		{
+			seenStarts_ = pll().starts();
+			for (auto& task : tasks()) { scheduleFirstRun(task, now); }
+		}
+		for (auto& task : tasks())
+		{
+			const auto runTime = taskTime(task);
+			if (signedDifference(now, runTime) >= 0)
+			{
+				task.task();
+				task.cycle += task.divider;
+				// Skip runs that are already over, e.g. after the task was blocked
+				while (signedDifference(now, taskTime(task)) >= 0) { task.cycle += task.divider; }
+			}
+			deadline.add(taskTime(task));
+		}
+	}
+
+private:
+	struct ScheduledTask
+	{
+		Task task;
+		std::chrono::microseconds offset;
+		uint8_t divider;
+		// SYNC cycle of the next run
+		int64_t cycle;
+	};
+
+	static inline std::array<ScheduledTask, MaxTasks> tasks_{};
+	static inline std::size_t taskCount_{0};
+	// SyncPll::starts() the tasks are scheduled for
+	static inline uint32_t seenStarts_{0};
+
+	static const SyncPll&
+	pll()
+	{
+		return Device::syncPll_;
+	}
+
+	static std::span<ScheduledTask>
+	tasks()
+	{
+		return {tasks_.data(), taskCount_};
+	}
+
+	static int64_t
+	signedDifference(modm::PreciseClock::time_point a, modm::PreciseClock::time_point b)
+	{
+		using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+		return SignedRep((a - b).count());
+	}
+
+	static modm::PreciseClock::time_point
+	taskTime(const ScheduledTask& task)
+	{
+		return pll().syncTime(task.cycle) + task.offset;
+	}
+
+	/// First cycle divisible by the divider whose run time is still ahead
+	static void
+	scheduleFirstRun(ScheduledTask& task, modm::PreciseClock::time_point now)
+	{
+		task.cycle = (pll().cycle() / task.divider) * task.divider;
+		while (signedDifference(taskTime(task), now) <= 0) { task.cycle += task.divider; }
+	}
+};
+
+}  // namespace modm_canopen
+#endif
@@ -0,0 +1,134 @@
+#ifndef CANOPEN_TIME_CONSUMER_HPP
+#define CANOPEN_TIME_CONSUMER_HPP
+#include <modm/architecture/interface/can_message.hpp>
+#include <modm/processing/timer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "../object_dictionary.hpp"
+#include "../sdo_error.hpp"
+#include "../time_of_day.hpp"
+
+namespace modm_canopen
+{
+
+/// TIME consumer. Keeps an estimate of network time relative to the local PreciseClock, filtered
+/// over all received TIME messages so local clock drift is corrected in between.
+template<typename Device>
+class TimeConsumer
+{
+public:
+	/// Microseconds since 1984-01-01
+	using NetworkTime = std::chrono::microseconds;
+
+	static bool
+	isSynchronized()
+	{
+		return synchronized_;
+	}
+
+	static std::optional<NetworkTime>
+	networkTime()
+	{
+		return toNetworkTime(modm::PreciseClock::now());
+	}
+
+	/// Converts local timestamps up to half a PreciseClock wrap-around away from the last TIME
+	static std::optional<NetworkTime>
+	toNetworkTime(modm::PreciseClock::time_point local)
+	{
+		if (!synchronized_) return {};
+		const auto elapsed = localElapsed(referenceLocal_, local);
+		return referenceNetwork_ + elapsed + scaleDrift(elapsed);
+	}
+
+	template<typename MessageCallback>
+	static void
+	processMessage(const modm::can::Message &message, MessageCallback &&)
+	{
+		if (!consume_ || message.getIdentifier() != cobId_) return;
+		if (message.getLength() != TimeOfDay::Size) return;
+
+		const auto now = modm::PreciseClock::now();
+		const std::span<const uint8_t, TimeOfDay::Size> data{message.data, TimeOfDay::Size};
+		handleTime(now, TimeOfDay::decode(data).sinceEpoch());
+	}
+
+	constexpr void
+	registerHandlers(Device::Map &map)
+	{
+		if constexpr (Device::Map::hasEntry(Address{0x1012, 0}))
+		{
+			map.template setReadHandler<Address{0x1012, 0}>(
+				+[]() { return cobId_ | (consume_ ? 0x8000'0000u : 0u); });
+			map.template setWriteHandler<Address{0x1012, 0}>(+[](uint32_t value) {
+				// Producing TIME is up to the master
+				if (value & 0x4000'0000) return SdoErrorCode::UnsupportedAccess;
+				if (value & 0x2000'0000) return SdoErrorCode::InvalidValue;
+				consume_ = (value & 0x8000'0000) != 0;
+				cobId_ = value & 0x7FF;
+				return SdoErrorCode::NoError;
+			});
+		}
+	}
+
+private:
+	// A larger error is treated as a time jump of the producer, not as drift
+	static constexpr NetworkTime StepThreshold{std::chrono::milliseconds{10}};
+	static constexpr int32_t MaxDriftPpm = 500;
+
+	static inline uint32_t cobId_{0x100};
+	static inline bool consume_{true};
+
+	static inline bool synchronized_{false};
+	static inline modm::PreciseClock::time_point referenceLocal_{};
+	static inline NetworkTime referenceNetwork_{};
+	// Local clock drift in parts per billion
+	static inline int64_t driftPpb_{0};
+
+	static NetworkTime
+	localElapsed(modm::PreciseClock::time_point from, modm::PreciseClock::time_point to)
+	{
+		using Rep = modm::PreciseClock::rep;
+		const auto difference = std::chrono::duration_cast<std::chrono::microseconds>(to - from);
+		// PreciseClock may wrap around, the difference is only meaningful as a signed value
+		return NetworkTime{std::make_signed_t<Rep>(Rep(difference.count()))};
+	}
+
+	static NetworkTime
+	scaleDrift(NetworkTime elapsed)
+	{
+		return NetworkTime{elapsed.count() * driftPpb_ / 1'000'000'000};
+	}
+
+	static void
+	handleTime(modm::PreciseClock::time_point local, NetworkTime received)
+	{
+		const auto predicted = toNetworkTime(local);
+		const auto elapsed = localElapsed(referenceLocal_, local);
+		if (!predicted || std::chrono::abs(received - *predicted) > StepThreshold ||
+			elapsed.count() <= 0)
+		{
+			synchronized_ = true;
+			referenceLocal_ = local;
+			referenceNetwork_ = received;
+			return;
+		}
+
+		// Proportional-integral correction: the offset follows a quarter of the error, the drift
+		// estimate integrates it so the prediction between two TIME messages stays accurate
+		const auto error = received - *predicted;
+		referenceLocal_ = local;
+		referenceNetwork_ = *predicted + error / 4;
+		const int64_t errorPpb = error.count() * 1'000'000'000 / elapsed.count();
+		driftPpb_ = std::clamp<int64_t>(driftPpb_ + errorPpb / 16, -MaxDriftPpm * 1000,
+										MaxDriftPpm * 1000);
+	}
+};
+
+}  // namespace modm_canopen
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <cstdint>
+namespace modm_canopen
+{
+// CiA 305 layer setting services
+inline constexpr uint32_t LssMasterCobId = 0x7E5;
+inline constexpr uint32_t LssSlaveCobId = 0x7E4;
+inline constexpr uint8_t LssUnconfiguredNodeId = 0xFF;
+
+/// Vendor id, product code, revision number and serial number as in 0x1018 sub 1-4
+using LssAddress = std::array<uint32_t, 4>;
+
+enum class LSSCommand : uint8_t
+{
+	SwitchStateGlobal = 0x04,
+	ConfigureNodeId = 0x11,
+	ConfigureBitTiming = 0x13,
+	ActivateBitTiming = 0x15,
+	StoreConfiguration = 0x17,
+	SwitchStateSelectiveVendor = 0x40,
+	SwitchStateSelectiveProduct = 0x41,
+	SwitchStateSelectiveRevision = 0x42,
+	SwitchStateSelectiveSerial = 0x43,
+	SwitchStateSelectiveResponse = 0x44,
+	IdentifyRemoteVendor = 0x46,
+	IdentifyRemoteProduct = 0x47,
+	IdentifyRemoteRevisionLow = 0x48,
+	IdentifyRemoteRevisionHigh = 0x49,
+	IdentifyRemoteSerialLow = 0x4A,
+	IdentifyRemoteSerialHigh = 0x4B,
+	IdentifyNonConfiguredRemote = 0x4C,
+	IdentifySlave = 0x4F,
+	IdentifyNonConfiguredSlave = 0x50,
+	FastScan = 0x51,
+	InquireVendor = 0x5A,
+	InquireProduct = 0x5B,
+	InquireRevision = 0x5C,
+	InquireSerial = 0x5D,
+	InquireNodeId = 0x5E,
+};
+
+/// bitChecked value of a Fast Scan request that resets the scan on all slaves
+inline constexpr uint8_t LssFastScanReset = 0x80;
+}  // namespace modm_canopen
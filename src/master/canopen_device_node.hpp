@@ -2,11 +2,14 @@
 #define CANOPEN_CANOPEN_DEVICE_NODE_HPP
 
 #include <array>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <span>
 #include <mutex>
 #include "../object_dictionary.hpp"
 #include "handler_map_rt.hpp"
+#include "process_image.hpp"
 #include "../receive_pdo.hpp"
 #include "../receive_pdo_configurator.hpp"
 #include "../transmit_pdo_configurator.hpp"
@@ -31,10 +34,12 @@ public:
 	using ReceivePdo_t = ReceivePdo<ObjectDictionary>;
 	using TransmitPdo_t = TransmitPdo<ObjectDictionary>;
 
-	CanopenNode(uint8_t nodeId, Map map) : nodeId_(nodeId), accessHandlers(map) {};
+	CanopenNode(uint8_t nodeId, Map map) : nodeId_(nodeId) { updateHandlers(std::move(map)); };
 
 	CanopenNode(uint8_t nodeId) : CanopenNode(nodeId, constructHandlerMap(nodeId)) {};
 
+	/// Meant for reconfiguration, not the cyclic path. A replaced map is freed once no read() or
+	/// write() that may still use it is running.
 	void
 	updateHandlers(Map map);
 
@@ -62,13 +67,44 @@ private:
 	auto
 	constructHandlerMap(uint8_t id) -> Map;
 
-	std::optional<ReadHandlerRT>
-	getReadHandler(Address addr);
-	std::optional<WriteHandlerRT>
-	getWriteHandler(Address addr);
+	// Replaced as a whole, accesses only load the pointer. Each access is counted in the counter of
+	// the epoch it started in, a replaced map is freed two epochs later. A new epoch only starts
+	// once the counter it reuses dropped to zero.
+	std::atomic<const Map*> handlers_{nullptr};
+	std::atomic<uint32_t> epoch_{0};
+	std::array<std::atomic<uint32_t>, 2> handlerUsers_{};
+	std::atomic<bool> hasRetiredMaps_{false};
+	std::mutex mapsMutex_{};
+	std::unique_ptr<const Map> map_{};
+	struct RetiredMap
+	{
+		std::unique_ptr<const Map> map;
+		uint32_t epoch;
+	};
+	std::vector<RetiredMap> retiredMaps_{};
+
+	/// Keeps the map loaded on construction alive
+	struct HandlersGuard
+	{
+		CanopenNode& node;
+		uint32_t epoch;
+		const Map* map;
+
+		explicit HandlersGuard(CanopenNode& node_)
+			: node{node_}, epoch{node_.acquireHandlers()}, map{node_.handlers_.load()}
+		{}
 
-	Map accessHandlers;
-	std::mutex handlerMutex_{};
+		~HandlersGuard() { node.releaseHandlers(epoch); }
+	};
+
+	uint32_t
+	acquireHandlers();
+	void
+	releaseHandlers(uint32_t epoch);
+	// mapsMutex_ has to be held
+	void
+	reclaimMaps();
+	ProcessImage<ObjectDictionary> processImage_{};
 
 	void
 	updateRPDOAddrs();
@@ -104,6 +140,24 @@ public:
 	std::optional<Value>
 	toValue(Address address, std::span<const uint8_t> data, int8_t size = -1);
 
+	/// Value last received from the node or set locally, address and type are resolved at
+	/// compile time. Objects are generated per EDS by od_generator.py --objects.
+	template<typename Object>
+	std::optional<typename Object::Type>
+	get() const
+	{
+		return processImage_.template load<Object>();
+	}
+
+	/// Sets a value sent to the node, used for objects without a read handler
+	template<typename Object>
+	void
+	set(typename Object::Type value)
+	{
+		processImage_.template store<Object>(value);
+		setValueChanged(Object::address);
+	}
+
 	SdoErrorCode
 	setReceivePdoActive(uint8_t index, bool active);
 	SdoErrorCode
@@ -16,19 +16,17 @@ CanopenNode<OD, Protocols...>::write(Address address, Value value) -> SdoErrorCo
 		return SdoErrorCode::UnsupportedAccess;
 	}
 
-	auto handler = getWriteHandler(address);
-	if (handler)
-	{
-		const auto result = callWriteHandler(*handler, value);
-		if (result == SdoErrorCode::NoError) { setValueChanged(address); }
-		return result;
-	} else if (!entry->isWritable())
-	{
-		return SdoErrorCode::WriteOfReadOnlyObject;
-	} else
-	{  // TODO: can this happen?
-		return SdoErrorCode::UnsupportedAccess;
-	}
+	const HandlersGuard handlers{*this};
+	const auto* handler = handlers.map->lookupWriteHandler(address);
+	if (!handler) { return SdoErrorCode::WriteOfReadOnlyObject; }
+
+	processImage_.store(address, value);
+	// Without a handler the value is only kept in the process image
+	const auto result = std::holds_alternative<std::monostate>(*handler)
+							? SdoErrorCode::NoError
+							: callWriteHandler(*handler, value);
+	if (result == SdoErrorCode::NoError) { setValueChanged(address); }
+	return result;
 }
 
 template<typename OD, typename... Protocols>
@@ -42,22 +40,6 @@ CanopenNode<OD, Protocols...>::sync()
 	}
 }
 
-template<typename OD, typename... Protocols>
-std::optional<ReadHandlerRT>
-CanopenNode<OD, Protocols...>::getReadHandler(Address addr)
-{
-	std::unique_lock lock(handlerMutex_);
-	return accessHandlers.lookupReadHandler(addr);
-}
-
-template<typename OD, typename... Protocols>
-std::optional<WriteHandlerRT>
-CanopenNode<OD, Protocols...>::getWriteHandler(Address addr)
-{
-	std::unique_lock lock(handlerMutex_);
-	return accessHandlers.lookupWriteHandler(addr);
-}
-
 template<typename OD, typename... Protocols>
 std::optional<Value>
 CanopenNode<OD, Protocols...>::toValue(Address address, std::span<const uint8_t> data, int8_t size)
@@ -86,25 +68,22 @@ CanopenNode<OD, Protocols...>::write(Address address, std::span<const uint8_t> d
 		(objectSize <= data.size()) && ((size == -1) || (size == int8_t(objectSize)));
 	if (!sizeIsValid) { return SdoErrorCode::UnsupportedAccess; }
 
-	auto handler = getWriteHandler(address);
-	if (handler)
-	{
-		const Value value = valueFromBytes(entry->dataType, data);
-		const auto result = callWriteHandler(*handler, value);
-		if (result == SdoErrorCode::NoError) { setValueChanged(address); }
-
-		return result;
-	}
-	return SdoErrorCode::UnsupportedAccess;
+	return write(address, valueFromBytes(entry->dataType, data));
 }
 
 template<typename OD, typename... Protocols>
 auto
 CanopenNode<OD, Protocols...>::read(Address address) -> std::variant<Value, SdoErrorCode>
 {
-	auto handler = getReadHandler(address);
+	const HandlersGuard handlers{*this};
+	const auto* handler = handlers.map->lookupReadHandler(address);
 	if (handler)
 	{
+		// Objects without a handler are served from the process image
+		if (std::holds_alternative<std::monostate>(*handler))
+		{
+			if (auto value = processImage_.load(address)) { return *value; }
+		}
 		auto ret = callReadHandler(*handler);
 		if (!ret) return SdoErrorCode::GeneralError;
 		return *ret;
@@ -160,8 +139,43 @@ template<typename OD, typename... Protocols>
 void
 CanopenNode<OD, Protocols...>::updateHandlers(Map map)
 {
-	std::unique_lock lock(handlerMutex_);
-	accessHandlers = map;
+	std::unique_lock lock(mapsMutex_);
+	auto replacement = std::make_unique<const Map>(std::move(map));
+	handlers_.store(replacement.get());
+	if (map_) { retiredMaps_.push_back(RetiredMap{std::move(map_), epoch_.load()}); }
+	map_ = std::move(replacement);
+	reclaimMaps();
+}
+
+template<typename OD, typename... Protocols>
+uint32_t
+CanopenNode<OD, Protocols...>::acquireHandlers()
+{
+	const uint32_t epoch = epoch_.load();
+	handlerUsers_[epoch & 1].fetch_add(1);
+	return epoch;
+}
+
+template<typename OD, typename... Protocols>
+void
+CanopenNode<OD, Protocols...>::releaseHandlers(uint32_t epoch)
+{
+	if (handlerUsers_[epoch & 1].fetch_sub(1) != 1 || !hasRetiredMaps_.load()) return;
+	// Unless updateHandlers() is busy and reclaims anyway
+	std::unique_lock lock(mapsMutex_, std::try_to_lock);
+	if (lock) { reclaimMaps(); }
+}
+
+template<typename OD, typename... Protocols>
+void
+CanopenNode<OD, Protocols...>::reclaimMaps()
+{
+	// Accesses of the previous epoch are still running
+	const uint32_t epoch = epoch_.load();
+	if (handlerUsers_[(epoch + 1) & 1].load() != 0) return;
+	std::erase_if(retiredMaps_, [epoch](const auto& retired) { return retired.epoch != epoch; });
+	epoch_.store(epoch + 1);
+	hasRetiredMaps_.store(!retiredMaps_.empty());
 }
 
 template<typename OD, typename... Protocols>
@@ -17,7 +17,13 @@
 #include "../receive_pdo_configurator.hpp"
 #include "../transmit_pdo_configurator.hpp"
 #include "../transmit_pdo.hpp"
+#include "../time_of_day.hpp"
 #include "sdo_client.hpp"
+#include "sync_producer.hpp"
+#include "heartbeat_consumer.hpp"
+#include "configuration_cache.hpp"
+#include "lss_master.hpp"
+#include "emcy_consumer.hpp"
 #include "canopen_device_node.hpp"
 
 using namespace std::literals;
@@ -25,6 +31,8 @@ using namespace std::literals;
 namespace modm_canopen
 {
 
+/// One instance per CAN interface. Instances share no state, so every bus can be driven from its
+/// own thread.
 template<typename... Devices>
 class CanopenMaster
 {
@@ -34,124 +42,307 @@ public:
 	using DevicePtr_t = std::unique_ptr<Device>;
 	using Device_t = std::variant<std::monostate, DevicePtr_t<Devices>...>;
 
-	static void
+	CanopenMaster() = default;
+	CanopenMaster(const CanopenMaster&) = delete;
+	CanopenMaster&
+	operator=(const CanopenMaster&) = delete;
+
+	SdoClient_t&
+	sdoClient();
+
+	HeartbeatConsumer&
+	heartbeatConsumer();
+
+	LssMaster&
+	lssMaster();
+
+	/// processMessage() is the single writer, the history can be read from any thread
+	const EmcyConsumer&
+	emcyConsumer() const;
+	void
+	setEmcyCallback(EmcyConsumer::Callback&& callback);
+
+	void
 	setValueChangedAll(Address address);
 
-	static bool
+	bool
 	setValueChanged(uint8_t canID, Address address);
 
 	/// call on message reception
 	template<typename MessageCallback>
-	static void
+	void
 	processMessage(const modm::can::Message& message, MessageCallback&& responseCallback);
 
 	template<typename MessageCallback>
-	static void
+	void
 	update(MessageCallback&& cb);
 
 	template<typename Device>
-	static Device&
+	Device&
 	addDevice(uint8_t id);
 
 	template<typename Device>
-	static Device&
+	Device&
 	addDevice(uint8_t id, Device::Map map);
 
 	template<typename Device>
-	static Device&
+	Device&
 	getDevice(uint8_t id);
 
 	template<typename Device>
-	static Device*
+	Device*
 	tryGetDevice(uint8_t id);
 
-	static void
+	void
 	removeDevice(uint8_t id);
 
-	static std::vector<modm_canopen::Address>
+	std::vector<modm_canopen::Address>
 	getActiveTPDOAddrs(uint8_t id);
 
-	static std::vector<modm_canopen::Address>
+	std::vector<modm_canopen::Address>
 	getActiveRPDOAddrs(uint8_t id);
 
-	static bool
+	bool
 	isInSyncWindow();
-	static uint8_t
+	uint8_t
 	syncCounter();
 
-	static modm::PreciseClock::duration
+	modm::PreciseClock::duration
 	getSyncTimerPeriod();
-	static modm::PreciseClock::duration
+	void
+	setSyncTimerPeriod(modm::PreciseClock::duration period);
+	modm::PreciseClock::duration
 	getSyncWindowDuration();
 
+	/// Produce SYNC from a dedicated thread driven by an absolute timerfd instead of update().
+	/// sendMessage is called from that thread.
+	template<typename MessageCallback>
+	bool
+	startSyncThread(MessageCallback&& sendMessage, int realtimePriority = 0);
+	void
+	stopSyncThread();
+	const SyncJitterStatistics&
+	syncJitterStatistics() const;
+
+	/// Typed SDO upload, the value is stored in the process image of the node
+	template<typename Object, typename MessageCallback>
+	void
+	requestRead(uint8_t nodeId, MessageCallback&& sendMessage);
+
+	template<typename Object, typename MessageCallback>
+	void
+	requestRead(uint8_t nodeId, std::function<void(uint8_t, typename Object::Type)>&& callback,
+				MessageCallback&& sendMessage);
+
+	template<typename Object, typename MessageCallback>
+	void
+	requestWrite(uint8_t nodeId, typename Object::Type value, MessageCallback&& sendMessage);
+
+	/// Broadcast the system time with the TIME service from update(), a period of 0 disables it
+	void
+	setTimeProducerPeriod(std::chrono::milliseconds period);
+
+	template<typename MessageCallback>
+	void
+	sendTime(MessageCallback&& sendMessage);
+
+	/// Without a cache configureNode() always downloads the full configuration
+	void
+	setConfigurationCache(ConfigurationCache* cache);
+
+	/// Use an UNSIGNED32 hash of the configuration stored at address as fingerprint instead of
+	/// 0x1020 Verify configuration
+	void
+	setConfigurationHashObject(std::optional<Address> address);
+
+	void
+	setConfigurationCallback(std::function<void(uint8_t, ConfigurationResult)>&& callback);
+
+	/// Reads the fingerprint of the node and downloads nothing, the differing objects or the whole
+	/// configuration depending on the cache. Progresses in update().
+	template<typename MessageCallback>
+	void
+	configureNode(uint8_t nodeId, NodeConfiguration configuration, MessageCallback&& sendMessage);
+
+	bool
+	isConfiguring(uint8_t nodeId);
+
 private:
 	friend SdoClient_t;
-	static inline uint8_t masterId_{0};
+	uint8_t masterId_{0};
+
+	std::mutex devicesMutex_{};
+	std::map<uint8_t, Device_t> devices_{};
 
-	static inline std::mutex devicesMutex_{};
-	static inline std::map<uint8_t, Device_t> devices_{};
+	std::mutex syncTimerMutex_{};
+	uint8_t syncCounterOverflow_{0};
+	uint8_t lastSyncCounter_{0};
+	uint32_t syncCobId_{0x80};
+	modm::PrecisePeriodicTimer syncTimer_{50ms};
+	modm::PreciseClock::duration syncWindowDuration_{25ms};
+	modm::PreciseClock::time_point lastSyncTime_{};
 
-	static inline std::mutex syncTimerMutex_{};
-	static inline uint8_t syncCounterOverflow_{0};
-	static inline uint8_t lastSyncCounter_{0};
-	static inline uint32_t syncCobId_{0x80};
-	static inline modm::PrecisePeriodicTimer syncTimer_{50ms};
-	static inline modm::PreciseClock::duration syncWindowDuration_{25ms};
-	static inline modm::PreciseClock::time_point lastSyncTime_{};
+	std::mutex timeMutex_{};
+	uint32_t timeCobId_{0x100};
+	std::optional<modm::PeriodicTimer> timeTimer_{};
+
+	SdoClient_t sdoClient_{*this};
+	HeartbeatConsumer heartbeatConsumer_{};
+	LssMaster lssMaster_{};
+	EmcyConsumer emcyConsumer_{};
 
 	template<typename MessageCallback>
-	static void
+	void
 	sendSync(MessageCallback&& sendMessage);
 
+	/// Returns TimerSyncProducer::now() taken right after the SYNC was sent
+	template<typename MessageCallback>
+	std::chrono::nanoseconds
+	produceSync(MessageCallback&& sendMessage);
+
+	struct ConfigurationTask
+	{
+		enum class State : uint8_t
+		{
+			ReadingFingerprint,
+			Downloading,
+		};
+
+		State state{State::ReadingFingerprint};
+		NodeConfiguration configuration{};
+		ConfigurationFingerprint fingerprint{};
+		std::optional<uint32_t> remoteDate{};
+		std::optional<uint32_t> remoteTime{};
+		bool aborted{false};
+		// Transfers of 0x1020 or the hash object are not an error, the node has no fingerprint
+		bool fingerprintAborted{false};
+		bool fingerprintReadable{true};
+		ConfigurationResult result{ConfigurationResult::Full};
+	};
+
+	// Never held while calling into sdoClient_, its callbacks lock it
+	std::mutex configurationMutex_{};
+	ConfigurationCache* configurationCache_{nullptr};
+	std::optional<Address> configurationHashObject_{};
+	std::function<void(uint8_t, ConfigurationResult)> configurationCallback_{};
+	std::map<uint8_t, ConfigurationTask> configurationTasks_{};
+
+	template<typename MessageCallback>
+	void
+	writeConfiguration(uint8_t nodeId, const NodeConfiguration& configuration,
+					   MessageCallback&& sendMessage);
+
+	template<typename MessageCallback>
+	void
+	updateConfiguration(MessageCallback&& sendMessage);
+
+	void
+	onConfigurationResponse(uint8_t nodeId, Address address, SdoErrorCode error);
+
+	// devicesMutex_ has to be held
+	template<typename Function, typename Result>
+	Result
+	visitDevice(uint8_t id, Result notFound, Function&& function);
+
 public:
 	// TODO: replace return value with std::expected like type, add error code to read handler
-	static auto
+	auto
 	read(uint8_t id, Address address) -> std::variant<Value, SdoErrorCode>;
-	static auto
+	auto
 	write(uint8_t id, Address address, Value value) -> SdoErrorCode;
-	static auto
+	auto
 	write(uint8_t id, Address address, std::span<const uint8_t> data,
 		  int8_t size = -1) -> SdoErrorCode;
 
-	static std::optional<Value>
+	std::optional<Value>
 	toValue(uint8_t id, Address address, std::span<const uint8_t> data, int8_t size = -1);
 
-	static uint32_t
+	/// Bulk local access under one lock, results[i] belongs to objects[i]. Nodes are looked up by
+	/// the id they were added with.
+	void
+	readMany(std::span<const NodeAddress> objects,
+			 std::span<std::variant<Value, SdoErrorCode>> results);
+	void
+	readMany(std::span<const uint8_t> nodeIds, Address address,
+			 std::span<std::variant<Value, SdoErrorCode>> results);
+	void
+	writeMany(std::span<const NodeAddress> objects, std::span<const Value> values,
+			  std::span<SdoErrorCode> results);
+	void
+	writeMany(std::span<const uint8_t> nodeIds, Address address, std::span<const Value> values,
+			  std::span<SdoErrorCode> results);
+
+	/// Pipelined SDO transfers, uploaded values are stored in the process images of the nodes
+	template<typename MessageCallback>
+	void
+	requestReadMany(std::span<const NodeAddress> objects, MessageCallback&& sendMessage);
+	template<typename MessageCallback>
+	void
+	requestReadMany(std::span<const uint8_t> nodeIds, Address address,
+					MessageCallback&& sendMessage);
+	template<typename MessageCallback>
+	void
+	requestWriteMany(std::span<const NodeAddress> objects, std::span<const Value> values,
+					 MessageCallback&& sendMessage);
+
+	uint32_t
 	rpdoCanId(uint8_t nodeId, uint8_t index);
-	static uint32_t
+	uint32_t
 	tpdoCanId(uint8_t nodeId, uint8_t index);
 
 	template<typename OD>
-	static void
+	void
 	setRPDO(uint8_t sourceId, uint8_t pdoId, ReceivePdo<OD>& pdo);
 	template<typename OD>
-	static void
+	void
 	setTPDO(uint8_t destinationId, uint8_t pdoId, TransmitPdo<OD>& pdo);
 
-	static SdoErrorCode
+	SdoErrorCode
 	setRPDOActive(uint8_t sourceId, uint8_t pdoId, bool active);
-	static SdoErrorCode
+	SdoErrorCode
 	setTPDOActive(uint8_t destinationId, uint8_t pdoId, bool active);
 
 	template<typename MessageCallback>
-	static void
+	void
 	setRemoteRPDOActive(uint8_t remoteId, uint8_t pdoId, bool active,
 						MessageCallback&& sendMessage);
 
 	template<typename MessageCallback>
-	static void
+	void
 	setRemoteTPDOActive(uint8_t remoteId, uint8_t pdoId, bool active,
 						MessageCallback&& sendMessage);
 
 	template<typename OD, typename MessageCallback>
-	static void
+	void
 	configureRemoteRPDO(uint8_t remoteId, uint8_t pdoId, TransmitPdo<OD> pdo,
 						MessageCallback&& sendMessage);
 
 	template<typename OD, typename MessageCallback>
-	static void
+	void
 	configureRemoteTPDO(uint8_t remoteId, uint8_t pdoId, ReceivePdo<OD> pdo,
 						uint16_t inhibitTime_100us, MessageCallback&& sendMessage);
+
+	void
+	setRemoteRPDOActive(uint8_t remoteId, uint8_t pdoId, bool active,
+						NodeConfiguration& configuration);
+
+	void
+	setRemoteTPDOActive(uint8_t remoteId, uint8_t pdoId, bool active,
+						NodeConfiguration& configuration);
+
+	template<typename OD>
+	void
+	configureRemoteRPDO(uint8_t remoteId, uint8_t pdoId, TransmitPdo<OD> pdo,
+						NodeConfiguration& configuration);
+
+	template<typename OD>
+	void
+	configureRemoteTPDO(uint8_t remoteId, uint8_t pdoId, ReceivePdo<OD> pdo,
+						uint16_t inhibitTime_100us, NodeConfiguration& configuration);
+
+private:
+	// Declared last, so the thread is stopped before anything it accesses is destroyed
+	TimerSyncProducer syncProducer_{};
 };
 
 }  // namespace modm_canopen
@@ -6,6 +6,41 @@
 namespace modm_canopen
 {
 
+template<typename... Devices>
+auto
+CanopenMaster<Devices...>::sdoClient() -> SdoClient_t &
+{
+	return sdoClient_;
+}
+
+template<typename... Devices>
+HeartbeatConsumer &
+CanopenMaster<Devices...>::heartbeatConsumer()
+{
+	return heartbeatConsumer_;
+}
+
+template<typename... Devices>
+LssMaster &
+CanopenMaster<Devices...>::lssMaster()
+{
+	return lssMaster_;
+}
+
+template<typename... Devices>
+const EmcyConsumer &
+CanopenMaster<Devices...>::emcyConsumer() const
+{
+	return emcyConsumer_;
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::setEmcyCallback(EmcyConsumer::Callback &&callback)
+{
+	emcyConsumer_.setCallback(std::move(callback));
+}
+
 template<typename... Devices>
 void
 CanopenMaster<Devices...>::removeDevice(uint8_t id)
@@ -184,23 +219,139 @@ CanopenMaster<Devices...>::read(uint8_t id, Address address) -> std::variant<Val
 	return SdoErrorCode::GeneralError;
 }
 
+template<typename... Devices>
+template<typename Function, typename Result>
+Result
+CanopenMaster<Devices...>::visitDevice(uint8_t id, Result notFound, Function &&function)
+{
+	const auto it = devices_.find(id);
+	if (it == devices_.end()) return notFound;
+	return std::visit(overloaded{[&notFound](std::monostate) { return notFound; },
+								 [&function](auto &&device) { return Result{function(*device)}; }},
+					  it->second);
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::readMany(std::span<const NodeAddress> objects,
+									std::span<std::variant<Value, SdoErrorCode>> results)
+{
+	using Result = std::variant<Value, SdoErrorCode>;
+	const auto count = std::min(objects.size(), results.size());
+	std::unique_lock lock(devicesMutex_);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const auto address = objects[i].address;
+		results[i] = visitDevice(objects[i].nodeId, Result{SdoErrorCode::GeneralError},
+								 [address](auto &device) { return device.read(address); });
+	}
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::readMany(std::span<const uint8_t> nodeIds, Address address,
+									std::span<std::variant<Value, SdoErrorCode>> results)
+{
+	using Result = std::variant<Value, SdoErrorCode>;
+	const auto count = std::min(nodeIds.size(), results.size());
+	std::unique_lock lock(devicesMutex_);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		results[i] = visitDevice(nodeIds[i], Result{SdoErrorCode::GeneralError},
+								 [address](auto &device) { return device.read(address); });
+	}
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::writeMany(std::span<const NodeAddress> objects,
+									 std::span<const Value> values, std::span<SdoErrorCode> results)
+{
+	const auto count = std::min({objects.size(), values.size(), results.size()});
+	std::unique_lock lock(devicesMutex_);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const auto address = objects[i].address;
+		const auto &value = values[i];
+		results[i] = visitDevice(
+			objects[i].nodeId, SdoErrorCode::GeneralError,
+			[address, &value](auto &device) { return device.write(address, value); });
+	}
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::writeMany(std::span<const uint8_t> nodeIds, Address address,
+									 std::span<const Value> values, std::span<SdoErrorCode> results)
+{
+	const auto count = std::min({nodeIds.size(), values.size(), results.size()});
+	std::unique_lock lock(devicesMutex_);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const auto &value = values[i];
+		results[i] = visitDevice(
+			nodeIds[i], SdoErrorCode::GeneralError,
+			[address, &value](auto &device) { return device.write(address, value); });
+	}
+}
+
+template<typename... Devices>
+template<typename MessageCallback>
+void
+CanopenMaster<Devices...>::requestReadMany(std::span<const NodeAddress> objects,
+										   MessageCallback &&sendMessage)
+{
+	sdoClient_.requestReadMany(objects, std::forward<MessageCallback>(sendMessage));
+}
+
+template<typename... Devices>
+template<typename MessageCallback>
+void
+CanopenMaster<Devices...>::requestReadMany(std::span<const uint8_t> nodeIds, Address address,
+										   MessageCallback &&sendMessage)
+{
+	std::vector<NodeAddress> objects;
+	objects.reserve(nodeIds.size());
+	for (const auto nodeId : nodeIds) { objects.push_back(NodeAddress{nodeId, address}); }
+	sdoClient_.requestReadMany(objects, std::forward<MessageCallback>(sendMessage));
+}
+
+template<typename... Devices>
+template<typename MessageCallback>
+void
+CanopenMaster<Devices...>::requestWriteMany(std::span<const NodeAddress> objects,
+											std::span<const Value> values,
+											MessageCallback &&sendMessage)
+{
+	sdoClient_.requestWriteMany(objects, values, std::forward<MessageCallback>(sendMessage));
+}
+
 template<typename... Devices>
 template<typename MessageCallback>
 void
 CanopenMaster<Devices...>::processMessage(const modm::can::Message &message, MessageCallback &&cb)
 {
+	if (heartbeatConsumer_.processMessage(message)) return;
+	if (lssMaster_.processMessage(message)) return;
+	if (emcyConsumer_.processMessage(message)) return;
+
+	const bool inSyncWindow = isInSyncWindow();
 	{
 		std::unique_lock lock(devicesMutex_);
 		for (auto &pair : devices_)
 		{
 			std::visit(overloaded{[](std::monostate) {},
-								  [&message](auto &&arg) {
-									  arg->processMessage(isInSyncWindow(), message);
+								  [&message, inSyncWindow](auto &&arg) {
+									  arg->processMessage(inSyncWindow, message);
 								  }},
 					   pair.second);
 		}
 	}
-	SdoClient_t::processMessage(message, std::forward<MessageCallback>(cb));
+	sdoClient_.processMessage(message,
+							  [this, &cb](uint8_t nodeId, Address address, SdoErrorCode error) {
+								  onConfigurationResponse(nodeId, address, error);
+								  cb(nodeId, address, error);
+							  });
 }
 
 template<typename... Devices>
@@ -208,35 +359,80 @@ template<typename MessageCallback>
 void
 CanopenMaster<Devices...>::update(MessageCallback &&cb)
 {
+	const bool inSyncWindow = isInSyncWindow();
 	{
 		std::unique_lock lock(devicesMutex_);
 		for (auto &pair : devices_)
 		{
 			std::visit(overloaded{[](std::monostate) {},
-								  [&cb](auto &&arg) {
-									  arg->update(isInSyncWindow(),
-												  std::forward<MessageCallback>(cb));
+								  [&cb, inSyncWindow](auto &&arg) {
+									  arg->update(inSyncWindow, std::forward<MessageCallback>(cb));
 								  }},
 					   pair.second);
 		}
 	}
 
-	SdoClient_t::update(cb);
+	sdoClient_.update(cb);
+	updateConfiguration(cb);
+	heartbeatConsumer_.update();
+	lssMaster_.update(cb);
+
+	bool timeDue = false;
+	{
+		std::unique_lock lock(timeMutex_);
+		timeDue = timeTimer_ && timeTimer_->execute();
+	}
+	if (timeDue) { sendTime(cb); }
+
+	if (syncProducer_.isRunning()) return;
+	{
+		std::unique_lock lock(syncTimerMutex_);
+		if (!syncTimer_.execute()) return;
+	}
+	produceSync(std::forward<MessageCallback>(cb));
+}
 
+template<typename... Devices>
+template<typename MessageCallback>
+std::chrono::nanoseconds
+CanopenMaster<Devices...>::produceSync(MessageCallback &&sendMessage)
+{
 	{
 		std::unique_lock lock(syncTimerMutex_);
-		if (syncTimer_.execute())
-		{
-			sendSync(std::forward<MessageCallback>(cb));
-			lock.unlock();
-			lock = std::unique_lock<std::mutex>(devicesMutex_);
-			for (auto &pair : devices_)
-			{
-				std::visit(overloaded{[](std::monostate) {}, [](auto &&arg) { arg->sync(); }},
-						   pair.second);
-			}
-		}
+		sendSync(std::forward<MessageCallback>(sendMessage));
 	}
+	const auto sent = TimerSyncProducer::now();
+	std::unique_lock lock(devicesMutex_);
+	for (auto &pair : devices_)
+	{
+		std::visit(overloaded{[](std::monostate) {}, [](auto &&arg) { arg->sync(); }}, pair.second);
+	}
+	return sent;
+}
+
+template<typename... Devices>
+template<typename MessageCallback>
+bool
+CanopenMaster<Devices...>::startSyncThread(MessageCallback &&sendMessage, int realtimePriority)
+{
+	const auto period = std::chrono::duration_cast<std::chrono::microseconds>(getSyncTimerPeriod());
+	return syncProducer_.start(
+		period, [this, sendMessage]() mutable { return produceSync(sendMessage); },
+		realtimePriority);
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::stopSyncThread()
+{
+	syncProducer_.stop();
+}
+
+template<typename... Devices>
+const SyncJitterStatistics &
+CanopenMaster<Devices...>::syncJitterStatistics() const
+{
+	return syncProducer_.statistics();
 }
 
 template<typename... Devices>
@@ -253,9 +449,78 @@ template<typename... Devices>
 modm::PreciseClock::duration
 CanopenMaster<Devices...>::getSyncTimerPeriod()
 {
+	std::unique_lock lock(syncTimerMutex_);
 	return syncTimer_.interval();
 }
 
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::setSyncTimerPeriod(modm::PreciseClock::duration period)
+{
+	std::unique_lock lock(syncTimerMutex_);
+	syncTimer_.restart(period);
+}
+
+template<typename... Devices>
+template<typename Object, typename MessageCallback>
+void
+CanopenMaster<Devices...>::requestRead(uint8_t nodeId, MessageCallback &&sendMessage)
+{
+	sdoClient_.requestRead(nodeId, Object::address, std::forward<MessageCallback>(sendMessage));
+}
+
+template<typename... Devices>
+template<typename Object, typename MessageCallback>
+void
+CanopenMaster<Devices...>::requestRead(
+	uint8_t nodeId, std::function<void(uint8_t, typename Object::Type)> &&callback,
+	MessageCallback &&sendMessage)
+{
+	sdoClient_.requestRead(
+		nodeId, Object::address, Object::dataType,
+		[callback = std::move(callback)](uint8_t id, Value value) {
+			const auto *typed = std::get_if<typename Object::Type>(&value);
+			if (typed) { callback(id, *typed); }
+		},
+		std::forward<MessageCallback>(sendMessage));
+}
+
+template<typename... Devices>
+template<typename Object, typename MessageCallback>
+void
+CanopenMaster<Devices...>::requestWrite(uint8_t nodeId, typename Object::Type value,
+										MessageCallback &&sendMessage)
+{
+	sdoClient_.requestWrite(nodeId, Object::address, Value{value},
+							std::forward<MessageCallback>(sendMessage));
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::setTimeProducerPeriod(std::chrono::milliseconds period)
+{
+	std::unique_lock lock(timeMutex_);
+	if (period.count() == 0)
+	{
+		timeTimer_.reset();
+	} else
+	{
+		timeTimer_.emplace(period);
+	}
+}
+
+template<typename... Devices>
+template<typename MessageCallback>
+void
+CanopenMaster<Devices...>::sendTime(MessageCallback &&sendMessage)
+{
+	const auto time = TimeOfDay::fromSystemClock(std::chrono::system_clock::now());
+	modm::can::Message msg(timeCobId_, TimeOfDay::Size);
+	msg.setExtended(false);
+	time.encode(std::span<uint8_t, TimeOfDay::Size>{msg.data, TimeOfDay::Size});
+	sendMessage(msg);
+}
+
 template<typename... Devices>
 modm::PreciseClock::duration
 CanopenMaster<Devices...>::getSyncWindowDuration()
@@ -376,7 +641,48 @@ void
 CanopenMaster<Devices...>::setRemoteRPDOActive(uint8_t remoteId, uint8_t pdoId, bool active,
 											   MessageCallback &&sendMessage)
 {
+	NodeConfiguration configuration{};
+	setRemoteRPDOActive(remoteId, pdoId, active, configuration);
+	writeConfiguration(remoteId, configuration, std::forward<MessageCallback>(sendMessage));
+}
+template<typename... Devices>
+template<typename MessageCallback>
+void
+CanopenMaster<Devices...>::setRemoteTPDOActive(uint8_t remoteId, uint8_t pdoId, bool active,
+											   MessageCallback &&sendMessage)
+{
+	NodeConfiguration configuration{};
+	setRemoteTPDOActive(remoteId, pdoId, active, configuration);
+	writeConfiguration(remoteId, configuration, std::forward<MessageCallback>(sendMessage));
+}
+
+template<typename... Devices>
+template<typename OD, typename MessageCallback>
+void
+CanopenMaster<Devices...>::configureRemoteRPDO(uint8_t remoteId, uint8_t pdoId, TransmitPdo<OD> pdo,
+											   MessageCallback &&sendMessage)
+{
+	NodeConfiguration configuration{};
+	configureRemoteRPDO(remoteId, pdoId, pdo, configuration);
+	writeConfiguration(remoteId, configuration, std::forward<MessageCallback>(sendMessage));
+}
+template<typename... Devices>
+template<typename OD, typename MessageCallback>
+void
+CanopenMaster<Devices...>::configureRemoteTPDO(uint8_t remoteId, uint8_t pdoId, ReceivePdo<OD> pdo,
+											   uint16_t inhibitTime_100us,
+											   MessageCallback &&sendMessage)
+{
+	NodeConfiguration configuration{};
+	configureRemoteTPDO(remoteId, pdoId, pdo, inhibitTime_100us, configuration);
+	writeConfiguration(remoteId, configuration, std::forward<MessageCallback>(sendMessage));
+}
 
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::setRemoteRPDOActive(uint8_t remoteId, uint8_t pdoId, bool active,
+											   NodeConfiguration &configuration)
+{
 	const uint16_t rpdoCommParamAddr = 0x1400 + pdoId;
 	const auto rpdoCobIdAddr = Address{rpdoCommParamAddr, 1};
 	const uint32_t rpdoCobId =
@@ -384,14 +690,12 @@ CanopenMaster<Devices...>::setRemoteRPDOActive(uint8_t remoteId, uint8_t pdoId,
 		(active ? 0 : 0x8000'0000);  // Needs to be tpdoCanId, since they are
 									 // reversed on master...
 									 // TODO find a way to make that consistent
-	SdoClient_t::requestWrite(remoteId, rpdoCobIdAddr, (uint32_t)rpdoCobId,
-							  std::forward<MessageCallback>(sendMessage));
+	configuration.write(rpdoCobIdAddr, (uint32_t)rpdoCobId);
 }
 template<typename... Devices>
-template<typename MessageCallback>
 void
 CanopenMaster<Devices...>::setRemoteTPDOActive(uint8_t remoteId, uint8_t pdoId, bool active,
-											   MessageCallback &&sendMessage)
+											   NodeConfiguration &configuration)
 {
 	uint16_t tpdoCommParamAddr = 0x1800 + pdoId;
 	const auto tpdoCobIdAddr = Address{tpdoCommParamAddr, 1};
@@ -400,68 +704,270 @@ CanopenMaster<Devices...>::setRemoteTPDOActive(uint8_t remoteId, uint8_t pdoId,
 		(active ? 0 : 0x8000'0000);  // Needs to be rpdoCanId, since they are
 									 // reversed on master...
 									 // TODO find a way to make that consistent
-	SdoClient_t::requestWrite(remoteId, tpdoCobIdAddr, (uint32_t)tpdoCobId,
-							  std::forward<MessageCallback>(sendMessage));
+	configuration.write(tpdoCobIdAddr, (uint32_t)tpdoCobId);
 }
 
 template<typename... Devices>
-template<typename OD, typename MessageCallback>
+template<typename OD>
 void
 CanopenMaster<Devices...>::configureRemoteRPDO(uint8_t remoteId, uint8_t pdoId, TransmitPdo<OD> pdo,
-											   MessageCallback &&sendMessage)
+											   NodeConfiguration &configuration)
 {
 	pdo.setInactive();
-	setRemoteRPDOActive(remoteId, pdoId, false, std::forward<MessageCallback>(sendMessage));
+	setRemoteRPDOActive(remoteId, pdoId, false, configuration);
 	const uint16_t rpdoCommParamAddr = 0x1400 + pdoId;
 	const auto rpdoCobId = Address{rpdoCommParamAddr, 1};
-	SdoClient_t::requestWrite(remoteId, rpdoCobId, (uint32_t)pdo.cobId(),
-							  std::forward<MessageCallback>(sendMessage));
+	configuration.write(rpdoCobId, (uint32_t)pdo.cobId());
 
 	const uint16_t rpdoMapParamAddr = 0x1600 + pdoId;
 
 	for (uint8_t i = 0; i < pdo.mappingCount(); i++)
 	{
 		const auto rpdoMappingAddr = Address{rpdoMapParamAddr, (uint8_t)(i + 1)};
-		SdoClient_t::requestWrite(remoteId, rpdoMappingAddr, (uint32_t)pdo.mapping(i).encode(),
-								  std::forward<MessageCallback>(sendMessage));
+		configuration.write(rpdoMappingAddr, (uint32_t)pdo.mapping(i).encode());
 	}
 
 	const auto rpdoMappingCount = Address{rpdoMapParamAddr, 0};
-	SdoClient_t::requestWrite(remoteId, rpdoMappingCount, (uint8_t)pdo.mappingCount(),
-							  std::forward<MessageCallback>(sendMessage));
-	setRemoteRPDOActive(remoteId, pdoId, true, std::forward<MessageCallback>(sendMessage));
+	configuration.write(rpdoMappingCount, (uint8_t)pdo.mappingCount());
+	setRemoteRPDOActive(remoteId, pdoId, true, configuration);
 }
 template<typename... Devices>
-template<typename OD, typename MessageCallback>
+template<typename OD>
 void
 CanopenMaster<Devices...>::configureRemoteTPDO(uint8_t remoteId, uint8_t pdoId, ReceivePdo<OD> pdo,
 											   uint16_t inhibitTime_100us,
-											   MessageCallback &&sendMessage)
+											   NodeConfiguration &configuration)
 {
 	pdo.setInactive();
-	setRemoteTPDOActive(remoteId, pdoId, false, std::forward<MessageCallback>(sendMessage));
+	setRemoteTPDOActive(remoteId, pdoId, false, configuration);
 	uint16_t tpdoCommParamAddr = 0x1800 + pdoId;
 	const auto tpdoCobId = Address{tpdoCommParamAddr, 1};
-	SdoClient_t::requestWrite(remoteId, tpdoCobId, (uint32_t)pdo.cobId(),
-							  std::forward<MessageCallback>(sendMessage));
+	configuration.write(tpdoCobId, (uint32_t)pdo.cobId());
 
 	const auto tpdoInhibitTime = Address{tpdoCommParamAddr, 3};
-	SdoClient_t::requestWrite(remoteId, tpdoInhibitTime, inhibitTime_100us,
-							  std::forward<MessageCallback>(sendMessage));
+	configuration.write(tpdoInhibitTime, inhibitTime_100us);
 
 	uint16_t tpdoMapParamAddr = 0x1A00 + pdoId;
 
 	for (uint8_t i = 0; i < pdo.mappingCount(); i++)
 	{
 		const auto tpdoMappingAddr = Address{tpdoMapParamAddr, (uint8_t)(i + 1)};
-		SdoClient_t::requestWrite(remoteId, tpdoMappingAddr, (uint32_t)pdo.mapping(i).encode(),
-								  std::forward<MessageCallback>(sendMessage));
+		configuration.write(tpdoMappingAddr, (uint32_t)pdo.mapping(i).encode());
 	}
 	const auto tpdoMappingCount = Address{tpdoMapParamAddr, 0};
-	SdoClient_t::requestWrite(remoteId, tpdoMappingCount, (uint8_t)pdo.mappingCount(),
-							  std::forward<MessageCallback>(sendMessage));
+	configuration.write(tpdoMappingCount, (uint8_t)pdo.mappingCount());
 
-	setRemoteTPDOActive(remoteId, pdoId, true, std::forward<MessageCallback>(sendMessage));
+	setRemoteTPDOActive(remoteId, pdoId, true, configuration);
+}
+
+template<typename... Devices>
+template<typename MessageCallback>
+void
+CanopenMaster<Devices...>::writeConfiguration(uint8_t nodeId,
+											  const NodeConfiguration &configuration,
+											  MessageCallback &&sendMessage)
+{
+	for (const auto &[address, value] : configuration.objects())
+	{
+		sdoClient_.requestWrite(nodeId, address, value, std::forward<MessageCallback>(sendMessage));
+	}
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::setConfigurationCache(ConfigurationCache *cache)
+{
+	std::unique_lock lock(configurationMutex_);
+	configurationCache_ = cache;
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::setConfigurationHashObject(std::optional<Address> address)
+{
+	std::unique_lock lock(configurationMutex_);
+	configurationHashObject_ = address;
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::setConfigurationCallback(
+	std::function<void(uint8_t, ConfigurationResult)> &&callback)
+{
+	std::unique_lock lock(configurationMutex_);
+	configurationCallback_ = std::move(callback);
+}
+
+template<typename... Devices>
+bool
+CanopenMaster<Devices...>::isConfiguring(uint8_t nodeId)
+{
+	std::unique_lock lock(configurationMutex_);
+	return configurationTasks_.contains(nodeId);
+}
+
+template<typename... Devices>
+template<typename MessageCallback>
+void
+CanopenMaster<Devices...>::configureNode(uint8_t nodeId, NodeConfiguration configuration,
+										 MessageCallback &&sendMessage)
+{
+	std::unique_lock lock(configurationMutex_);
+	auto &task = configurationTasks_[nodeId];
+	task = ConfigurationTask{};
+	task.configuration = std::move(configuration);
+	if (!configurationCache_)
+	{
+		task.state = ConfigurationTask::State::Downloading;
+		const auto writes = task.configuration;
+		lock.unlock();
+		writeConfiguration(nodeId, writes, std::forward<MessageCallback>(sendMessage));
+		return;
+	}
+
+	const auto hashObject = configurationHashObject_;
+	if (hashObject) { task.remoteTime = 0; }
+	lock.unlock();
+
+	auto store = [this](bool isDate) {
+		return [this, isDate](const uint8_t id, Value value) {
+			std::unique_lock lock(configurationMutex_);
+			auto it = configurationTasks_.find(id);
+			if (it == configurationTasks_.end() || !std::holds_alternative<uint32_t>(value)) return;
+			(isDate ? it->second.remoteDate : it->second.remoteTime) = std::get<uint32_t>(value);
+		};
+	};
+	if (hashObject)
+	{
+		sdoClient_.requestRead(nodeId, *hashObject, DataType::UInt32, store(true),
+							   std::forward<MessageCallback>(sendMessage));
+	} else
+	{
+		sdoClient_.requestRead(nodeId, Address{0x1020, 1}, DataType::UInt32, store(true),
+							   std::forward<MessageCallback>(sendMessage));
+		sdoClient_.requestRead(nodeId, Address{0x1020, 2}, DataType::UInt32, store(false),
+							   std::forward<MessageCallback>(sendMessage));
+	}
+}
+
+template<typename... Devices>
+void
+CanopenMaster<Devices...>::onConfigurationResponse(uint8_t nodeId, Address address,
+												   SdoErrorCode error)
+{
+	if (error == SdoErrorCode::NoError) return;
+	std::unique_lock lock(configurationMutex_);
+	auto it = configurationTasks_.find(nodeId);
+	if (it == configurationTasks_.end()) return;
+	const bool isFingerprint = configurationHashObject_ ? address == *configurationHashObject_
+														: address.index == 0x1020;
+	(isFingerprint ? it->second.fingerprintAborted : it->second.aborted) = true;
+}
+
+template<typename... Devices>
+template<typename MessageCallback>
+void
+CanopenMaster<Devices...>::updateConfiguration(MessageCallback &&sendMessage)
+{
+	std::vector<uint8_t> idle;
+	{
+		std::unique_lock lock(configurationMutex_);
+		for (const auto &pair : configurationTasks_) { idle.push_back(pair.first); }
+	}
+	if (idle.empty()) return;
+	// A task only advances once all of its SDO transfers are answered
+	std::erase_if(idle, [this](uint8_t nodeId) { return sdoClient_.waitingOn(nodeId); });
+
+	using Download = std::pair<uint8_t, NodeConfiguration>;
+	using Finished = std::pair<uint8_t, ConfigurationResult>;
+	std::vector<Download> downloads;
+	std::vector<Finished> finished;
+	std::function<void(uint8_t, ConfigurationResult)> callback;
+	bool cacheChanged = false;
+	{
+		std::unique_lock lock(configurationMutex_);
+		callback = configurationCallback_;
+		for (const uint8_t nodeId : idle)
+		{
+			auto it = configurationTasks_.find(nodeId);
+			if (it == configurationTasks_.end()) continue;
+			auto &task = it->second;
+
+			if (task.state == ConfigurationTask::State::ReadingFingerprint)
+			{
+				const auto cached = configurationCache_->find(nodeId);
+				const bool matches = cached && !task.aborted && task.remoteDate &&
+									 task.remoteTime &&
+									 cached->fingerprint.date == *task.remoteDate &&
+									 cached->fingerprint.time == *task.remoteTime;
+				const uint32_t hash = task.configuration.hash();
+				if (matches && cached->configurationHash == hash)
+				{
+					finished.emplace_back(nodeId, ConfigurationResult::Skipped);
+					configurationTasks_.erase(it);
+					continue;
+				}
+
+				// Without a matching fingerprint the state of the node is unknown
+				NodeConfiguration writes = matches
+											   ? task.configuration.diff(cached->configuration)
+											   : task.configuration;
+				task.result = matches ? ConfigurationResult::Partial : ConfigurationResult::Full;
+				// A node without fingerprint only gets the configuration
+				task.fingerprintReadable = !task.fingerprintAborted;
+				task.fingerprintAborted = false;
+				if (task.fingerprintReadable && configurationHashObject_)
+				{
+					task.fingerprint = ConfigurationFingerprint{.date = hash, .time = 0};
+					writes.write(*configurationHashObject_, task.fingerprint.date);
+				} else if (task.fingerprintReadable)
+				{
+					task.fingerprint = ConfigurationFingerprint::now();
+					writes.write(Address{0x1020, 1}, task.fingerprint.date);
+					writes.write(Address{0x1020, 2}, task.fingerprint.time);
+				}
+				task.aborted = false;
+				task.state = ConfigurationTask::State::Downloading;
+				downloads.emplace_back(nodeId, std::move(writes));
+				continue;
+			}
+
+			// Without a readable fingerprint the cache entry can never match, it is kept
+			if (configurationCache_ && task.fingerprintReadable)
+			{
+				if (task.aborted || task.fingerprintAborted)
+				{
+					// Forces a full download next time. A node that rejected the fingerprint
+					// still reports the old one, which no longer describes its configuration.
+					configurationCache_->erase(nodeId);
+				} else
+				{
+					configurationCache_->store(
+						nodeId, ConfigurationCache::Entry{
+									.fingerprint = task.fingerprint,
+									.configurationHash = task.configuration.hash(),
+									.configuration = std::move(task.configuration)});
+				}
+				cacheChanged = true;
+			}
+			finished.emplace_back(nodeId,
+								  task.aborted ? ConfigurationResult::Failed : task.result);
+			configurationTasks_.erase(it);
+		}
+		if (cacheChanged && !configurationCache_->save())
+		{
+			MODM_LOG_ERROR << "Failed to save configuration cache" << modm::endl;
+		}
+	}
+
+	for (const auto &[nodeId, writes] : downloads)
+	{
+		writeConfiguration(nodeId, writes, std::forward<MessageCallback>(sendMessage));
+	}
+	if (callback)
+	{
+		for (const auto &[nodeId, result] : finished) { callback(nodeId, result); }
+	}
 }
 
 template<typename... Devices>
@@ -0,0 +1,241 @@
+#include "configuration_cache.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+namespace modm_canopen
+{
+
+namespace
+{
+constexpr uint32_t FileMagic = 0x4346'4743;  // "CGFC"
+constexpr uint8_t FileVersion = 1;
+
+uint32_t
+unitKey(Address address)
+{
+	// Communication and mapping parameters of one PDO form a unit
+	if (address.index >= 0x1400 && address.index < 0x1C00)
+	{
+		const uint32_t isTransmit = address.index >= 0x1800;
+		return 0x100'0000 | (isTransmit << 9) | (address.index & 0x1FF);
+	}
+	return (uint32_t(address.index) << 8) | address.subindex;
+}
+
+template<typename T>
+void
+put(std::string& out, T value)
+{
+	out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool
+get(std::string_view& in, T& value)
+{
+	if (in.size() < sizeof(T)) return false;
+	std::memcpy(&value, in.data(), sizeof(T));
+	in.remove_prefix(sizeof(T));
+	return true;
+}
+}  // namespace
+
+void
+NodeConfiguration::write(Address address, Value value)
+{
+	objects_.emplace_back(address, value);
+}
+
+auto
+NodeConfiguration::objects() const -> const std::vector<Object>&
+{
+	return objects_;
+}
+
+bool
+NodeConfiguration::empty() const
+{
+	return objects_.empty();
+}
+
+uint32_t
+NodeConfiguration::hash() const
+{
+	// FNV-1a
+	uint32_t hash = 0x811C'9DC5;
+	auto add = [&hash](uint8_t byte) {
+		hash ^= byte;
+		hash *= 0x0100'0193;
+	};
+	for (const auto& [address, value] : objects_)
+	{
+		std::array<uint8_t, 8> data{};
+		valueToBytes(value, data);
+		add(address.index & 0xFF);
+		add(address.index >> 8);
+		add(address.subindex);
+		add(value.index());
+		for (uint8_t byte : data) { add(byte); }
+	}
+	return hash;
+}
+
+NodeConfiguration
+NodeConfiguration::diff(const NodeConfiguration& previous) const
+{
+	std::map<uint32_t, std::vector<Object>> previousUnits;
+	for (const auto& object : previous.objects_)
+	{
+		previousUnits[unitKey(object.first)].push_back(object);
+	}
+
+	std::map<uint32_t, std::vector<Object>> units;
+	std::vector<uint32_t> order;
+	for (const auto& object : objects_)
+	{
+		auto [it, inserted] = units.try_emplace(unitKey(object.first));
+		if (inserted) { order.push_back(it->first); }
+		it->second.push_back(object);
+	}
+
+	NodeConfiguration out{};
+	for (const uint32_t key : order)
+	{
+		const auto& unit = units[key];
+		const auto previousUnit = previousUnits.find(key);
+		if (previousUnit != previousUnits.end() && previousUnit->second == unit) continue;
+		out.objects_.insert(out.objects_.end(), unit.begin(), unit.end());
+	}
+	return out;
+}
+
+ConfigurationFingerprint
+ConfigurationFingerprint::now()
+{
+	using namespace std::chrono;
+	constexpr sys_days Epoch{year{1984} / January / 1};
+	const auto now = system_clock::now();
+	const auto today = floor<days>(now);
+	return ConfigurationFingerprint{
+		.date = uint32_t((today - Epoch).count()),
+		.time = uint32_t(duration_cast<milliseconds>(now - today).count()),
+	};
+}
+
+ConfigurationCache::ConfigurationCache(std::string path) : path_(std::move(path)) {}
+
+bool
+ConfigurationCache::load()
+{
+	std::unique_lock lock(mutex_);
+	entries_.clear();
+
+	std::ifstream file(path_, std::ios::binary);
+	if (!file) return false;
+	const std::string content{std::istreambuf_iterator<char>(file), {}};
+	std::string_view in{content};
+
+	uint32_t magic{};
+	uint8_t version{};
+	uint8_t count{};
+	if (!get(in, magic) || !get(in, version) || !get(in, count)) return false;
+	if (magic != FileMagic || version != FileVersion) return false;
+
+	std::map<uint8_t, Entry> entries;
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		uint8_t nodeId{};
+		uint16_t objectCount{};
+		Entry entry{};
+		if (!get(in, nodeId) || !get(in, entry.fingerprint.date) ||
+			!get(in, entry.fingerprint.time) || !get(in, entry.configurationHash) ||
+			!get(in, objectCount))
+		{
+			return false;
+		}
+		for (uint16_t j = 0; j < objectCount; ++j)
+		{
+			Address address{};
+			uint8_t type{};
+			std::array<uint8_t, 8> data{};
+			if (!get(in, address.index) || !get(in, address.subindex) || !get(in, type) ||
+				!get(in, data) || type > uint8_t(DataType::Real32))
+			{
+				return false;
+			}
+			entry.configuration.write(address, valueFromBytes(DataType(type), data));
+		}
+		entries[nodeId] = std::move(entry);
+	}
+	entries_ = std::move(entries);
+	return true;
+}
+
+bool
+ConfigurationCache::save() const
+{
+	std::string out;
+	{
+		std::unique_lock lock(mutex_);
+		put(out, FileMagic);
+		put(out, FileVersion);
+		put(out, uint8_t(entries_.size()));
+		for (const auto& [nodeId, entry] : entries_)
+		{
+			const auto& objects = entry.configuration.objects();
+			put(out, nodeId);
+			put(out, entry.fingerprint.date);
+			put(out, entry.fingerprint.time);
+			put(out, entry.configurationHash);
+			put(out, uint16_t(objects.size()));
+			for (const auto& [address, value] : objects)
+			{
+				std::array<uint8_t, 8> data{};
+				valueToBytes(value, data);
+				put(out, address.index);
+				put(out, address.subindex);
+				put(out, uint8_t(value.index()));
+				put(out, data);
+			}
+		}
+	}
+
+	// Replace the file atomically, a crash while writing must not leave a truncated cache
+	const std::string temporary = path_ + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file.write(out.data(), out.size())) return false;
+	}
+	return std::rename(temporary.c_str(), path_.c_str()) == 0;
+}
+
+auto
+ConfigurationCache::find(uint8_t nodeId) const -> std::optional<Entry>
+{
+	std::unique_lock lock(mutex_);
+	const auto it = entries_.find(nodeId);
+	if (it == entries_.end()) return {};
+	return it->second;
+}
+
+void
+ConfigurationCache::store(uint8_t nodeId, Entry entry)
+{
+	std::unique_lock lock(mutex_);
+	entries_[nodeId] = std::move(entry);
+}
+
+void
+ConfigurationCache::erase(uint8_t nodeId)
+{
+	std::unique_lock lock(mutex_);
+	entries_.erase(nodeId);
+}
+
+}  // namespace modm_canopen
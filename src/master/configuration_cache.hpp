@@ -0,0 +1,104 @@
+#ifndef CANOPEN_CONFIGURATION_CACHE_HPP
+#define CANOPEN_CONFIGURATION_CACHE_HPP
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../object_dictionary.hpp"
+
+namespace modm_canopen
+{
+
+/// Objects written to a node during configuration, in download order.
+/// An address may appear several times, e.g. a PDO COB-ID that is disabled before remapping.
+class NodeConfiguration
+{
+public:
+	using Object = std::pair<Address, Value>;
+
+	void
+	write(Address address, Value value);
+
+	const std::vector<Object>&
+	objects() const;
+
+	bool
+	empty() const;
+
+	uint32_t
+	hash() const;
+
+	/// Writes needed to bring a node configured with previous up to this configuration.
+	/// Parameters of one PDO (communication and mapping) are only valid as a whole, so they are
+	/// rewritten as one unit if any of them differ.
+	NodeConfiguration
+	diff(const NodeConfiguration& previous) const;
+
+private:
+	std::vector<Object> objects_{};
+};
+
+/// Content of 0x1020 Verify configuration, or of a custom hash object in date only
+struct ConfigurationFingerprint
+{
+	uint32_t date{};  // days since 1984-01-01
+	uint32_t time{};  // milliseconds after midnight
+
+	static ConfigurationFingerprint
+	now();
+
+	constexpr friend bool
+	operator==(ConfigurationFingerprint, ConfigurationFingerprint) = default;
+};
+
+enum class ConfigurationResult : uint8_t
+{
+	Skipped,  // fingerprint and configuration matched the cache
+	Partial,  // only the differing objects were written
+	Full,     // no usable cache entry or the node did not report the cached fingerprint
+	Failed,   // a write was aborted, the cache entry of the node was dropped
+};
+
+/// Persisted record of what was last downloaded to every node
+class ConfigurationCache
+{
+public:
+	struct Entry
+	{
+		ConfigurationFingerprint fingerprint{};
+		uint32_t configurationHash{};
+		NodeConfiguration configuration{};
+	};
+
+	explicit ConfigurationCache(std::string path);
+
+	/// Returns false if the file does not exist or is not a valid cache, the cache is empty then
+	bool
+	load();
+
+	bool
+	save() const;
+
+	std::optional<Entry>
+	find(uint8_t nodeId) const;
+
+	void
+	store(uint8_t nodeId, Entry entry);
+
+	void
+	erase(uint8_t nodeId);
+
+private:
+	std::string path_;
+	mutable std::mutex mutex_{};
+	std::map<uint8_t, Entry> entries_{};
+};
+
+}  // namespace modm_canopen
+
+#endif  // CANOPEN_CONFIGURATION_CACHE_HPP
@@ -0,0 +1,118 @@
+#include "emcy_consumer.hpp"
+
+#include <algorithm>
+
+namespace modm_canopen
+{
+
+namespace
+{
+constexpr uint32_t EmcyCobIdBase = 0x80;
+}
+
+void
+EmcyConsumer::setCallback(Callback&& callback)
+{
+	callback_ = std::move(callback);
+}
+
+bool
+EmcyConsumer::processMessage(const modm::can::Message& message,
+							 modm::PreciseClock::time_point now)
+{
+	const uint32_t id = message.getIdentifier();
+	// 0x80 itself is SYNC
+	if (id <= EmcyCobIdBase || id > EmcyCobIdBase + MaxNodeId) return false;
+	if (message.isRemoteTransmitRequest() || message.getLength() != 8) return false;
+
+	const uint8_t nodeId = id - EmcyCobIdBase;
+	auto& node = nodes_[nodeId];
+	const uint32_t index = node.count.load(std::memory_order_relaxed);
+	auto& slot = node.slots[index % HistoryDepth];
+
+	const uint64_t timestamp = now.time_since_epoch().count();
+	const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+	slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.index.store(index, std::memory_order_relaxed);
+	slot.words[0].store(message.data[0] | (message.data[1] << 8) | (message.data[2] << 16) |
+							(uint32_t(message.data[3]) << 24),
+						std::memory_order_relaxed);
+	slot.words[1].store(message.data[4] | (message.data[5] << 8) | (message.data[6] << 16) |
+							(uint32_t(message.data[7]) << 24),
+						std::memory_order_relaxed);
+	slot.words[2].store(uint32_t(timestamp), std::memory_order_relaxed);
+	slot.words[3].store(uint32_t(timestamp >> 32), std::memory_order_relaxed);
+	slot.sequence.store(sequence + 2, std::memory_order_release);
+	node.count.store(index + 1, std::memory_order_release);
+
+	if (callback_)
+	{
+		EmcyRecord record{};
+		if (read(node, index, record)) { callback_(nodeId, record); }
+	}
+	return true;
+}
+
+uint32_t
+EmcyConsumer::count(uint8_t nodeId) const
+{
+	if (nodeId > MaxNodeId) return 0;
+	return nodes_[nodeId].count.load(std::memory_order_acquire);
+}
+
+std::optional<EmcyRecord>
+EmcyConsumer::latest(uint8_t nodeId) const
+{
+	EmcyRecord record{};
+	if (history(nodeId, std::span<EmcyRecord>{&record, 1}) == 0) return {};
+	return record;
+}
+
+std::size_t
+EmcyConsumer::history(uint8_t nodeId, std::span<EmcyRecord> out) const
+{
+	if (nodeId > MaxNodeId) return 0;
+	const auto& node = nodes_[nodeId];
+	const uint32_t count = node.count.load(std::memory_order_acquire);
+	const std::size_t available = std::min<std::size_t>(count, HistoryDepth);
+
+	std::size_t copied = 0;
+	for (; copied < std::min(available, out.size()); ++copied)
+	{
+		// Stops at records the writer already replaced with newer ones
+		if (!read(node, count - 1 - copied, out[copied])) break;
+	}
+	return copied;
+}
+
+bool
+EmcyConsumer::read(const NodeHistory& node, uint32_t index, EmcyRecord& record) const
+{
+	const auto& slot = node.slots[index % HistoryDepth];
+	std::array<uint32_t, 4> words{};
+	uint32_t before = 0;
+	uint32_t after = 0;
+	do {
+		before = slot.sequence.load(std::memory_order_acquire);
+		if (before & 1) continue;
+		if (slot.index.load(std::memory_order_relaxed) != index) return false;
+		for (std::size_t i = 0; i < words.size(); ++i)
+		{
+			words[i] = slot.words[i].load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		after = slot.sequence.load(std::memory_order_relaxed);
+	} while ((before & 1) || before != after);
+
+	record.error = EMCYError(words[0] & 0xFFFF);
+	record.errorRegister = (words[0] >> 16) & 0xFF;
+	record.manufacturerError = {uint8_t(words[0] >> 24), uint8_t(words[1]), uint8_t(words[1] >> 8),
+								uint8_t(words[1] >> 16), uint8_t(words[1] >> 24)};
+	const uint64_t timestamp = words[2] | (uint64_t(words[3]) << 32);
+	record.timestamp = modm::PreciseClock::time_point{
+		modm::PreciseClock::duration{modm::PreciseClock::rep(timestamp)}};
+	return true;
+}
+
+}  // namespace modm_canopen
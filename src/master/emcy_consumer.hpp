@@ -0,0 +1,83 @@
+#ifndef CANOPEN_EMCY_CONSUMER_HPP
+#define CANOPEN_EMCY_CONSUMER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+
+#include <modm/architecture/interface/can_message.hpp>
+#include <modm/processing/timer.hpp>
+
+#include "../emcy_error.hpp"
+
+namespace modm_canopen
+{
+
+struct EmcyRecord
+{
+	EMCYError error{EMCYError::NoError};
+	uint8_t errorRegister{0};
+	std::array<uint8_t, 5> manufacturerError{};
+	modm::PreciseClock::time_point timestamp{};
+};
+
+/// Keeps the last HistoryDepth EMCY messages of every node.
+/// processMessage() must only be called from one thread, all readers are lock-free and may run
+/// concurrently on any other thread. Nothing is allocated per message.
+class EmcyConsumer
+{
+public:
+	static constexpr uint8_t MaxNodeId = 127;
+	static constexpr std::size_t HistoryDepth = 16;
+
+	/// Called from processMessage() for every received EMCY
+	using Callback = std::function<void(uint8_t nodeId, const EmcyRecord& record)>;
+
+	void
+	setCallback(Callback&& callback);
+
+	/// Returns true if the message was an EMCY
+	bool
+	processMessage(const modm::can::Message& message,
+				   modm::PreciseClock::time_point now = modm::PreciseClock::now());
+
+	/// Number of EMCY messages received from the node since start
+	uint32_t
+	count(uint8_t nodeId) const;
+
+	std::optional<EmcyRecord>
+	latest(uint8_t nodeId) const;
+
+	/// Copies the history of the node into out, newest first. Returns the number of records.
+	std::size_t
+	history(uint8_t nodeId, std::span<EmcyRecord> out) const;
+
+private:
+	// Records are stored as atomic words guarded by a per slot sequence counter (seqlock),
+	// so concurrent reads are race free without blocking the writer
+	struct Slot
+	{
+		std::atomic<uint32_t> sequence{0};
+		std::atomic<uint32_t> index{0};
+		std::array<std::atomic<uint32_t>, 4> words{};
+	};
+
+	struct NodeHistory
+	{
+		std::atomic<uint32_t> count{0};
+		std::array<Slot, HistoryDepth> slots{};
+	};
+
+	bool
+	read(const NodeHistory& node, uint32_t index, EmcyRecord& record) const;
+
+	std::array<NodeHistory, MaxNodeId + 1> nodes_{};
+	Callback callback_{};
+};
+
+}  // namespace modm_canopen
+
+#endif  // CANOPEN_EMCY_CONSUMER_HPP
@@ -1,4 +1,5 @@
 #pragma once
+#include <map>
 #include "handler_map_rt.hpp"
 #include "overloaded.hpp"
 
@@ -20,14 +21,14 @@ private:
 public:
 	template<typename ReturnT>
 	void
-	setReadHandler(Address address, std::function<std::optional<ReturnT>()> func)
+	setReadHandler(Address address, ReadFunctionRT<ReturnT> func)
 	{
 		readHandlers[address] = func;
 	}
 
 	template<typename Param>
 	void
-	setWriteHandler(Address address, std::function<SdoErrorCode(Param)> func)
+	setWriteHandler(Address address, WriteFunctionRT<Param> func)
 	{
 		writeHandlers[address] = func;
 	}
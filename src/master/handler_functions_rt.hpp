@@ -1,18 +1,19 @@
 #pragma once
 #include <variant>
-#include <functional>
 #include <optional>
 #include <cstdint>
 #include "../float_types.hpp"
 #include "../sdo_error.hpp"
+#include "inplace_function.hpp"
 
 namespace modm_canopen
 {
+// Stored inline, calling or copying a handler never allocates
 template<typename T>
-using ReadFunctionRT = std::function<std::optional<T>()>;
+using ReadFunctionRT = InplaceFunction<std::optional<T>()>;
 
 template<typename T>
-using WriteFunctionRT = std::function<SdoErrorCode(T)>;
+using WriteFunctionRT = InplaceFunction<SdoErrorCode(T)>;
 
 using ReadHandlerRT =
 	std::variant<std::monostate, ReadFunctionRT<uint8_t>, ReadFunctionRT<uint16_t>,
@@ -1,10 +1,11 @@
 #ifndef CANOPEN_HANDLER_MAP_RT_HPP
 #define CANOPEN_HANDLER_MAP_RT_HPP
 
+#include <array>
 #include <cassert>
-#include <map>
+#include <optional>
 #include "../handlers.hpp"
-#include "../object_dictionary_common.hpp"
+#include "../object_dictionary.hpp"
 
 #include <modm/debug/logger.hpp>
 
@@ -13,125 +14,110 @@
 namespace modm_canopen
 {
 
+/// Handlers of all objects in OD, stored in arrays indexed like the sorted OD::map.
+/// A lookup is one binary search over the constexpr map and returns a reference into the array.
 template<typename OD>
 class HandlerMapRT
 {
 public:
-	using ReadHandlerMapRT = std::map<Address, ReadHandlerRT>;
-	using WriteHandlerMapRT = std::map<Address, WriteHandlerRT>;
+	static constexpr std::size_t Size = OD::map.size();
 
 	HandlerMapRT() {}
 
 private:
-	static constexpr auto
-	makeReadHandlerMap() -> ReadHandlerMapRT
+	static constexpr const auto&
+	entry(std::size_t index)
 	{
-		ReadHandlerMapRT builder{};
-		for (const auto& [address, entry] : OD::map)
-		{
-			if (entry.isReadable()) { builder.emplace(address, ReadHandlerRT{}); }
-		}
-		return builder;
+		return (OD::map.begin() + index)->second;
 	}
 
-	static constexpr auto
-	makeWriteHandlerMap() -> WriteHandlerMapRT
-	{
-		WriteHandlerMapRT builder{};
-		for (const auto& [address, entry] : OD::map)
-		{
-			if (entry.isWritable()) { builder.emplace(address, WriteHandlerRT{}); }
-		}
-		return builder;
-	}
-
-	ReadHandlerMapRT readHandlers = makeReadHandlerMap();
-	WriteHandlerMapRT writeHandlers = makeWriteHandlerMap();
+	std::array<ReadHandlerRT, Size> readHandlers{};
+	std::array<WriteHandlerRT, Size> writeHandlers{};
 
 public:
-	std::optional<ReadHandlerRT>
+	/// Returns nullptr if the object does not exist or is not readable. Readable objects without a
+	/// registered handler yield an empty handler.
+	const ReadHandlerRT*
 	lookupReadHandler(Address address) const
 	{
-		if (readHandlers.count(address) == 0) return {};
-
-		return readHandlers.at(address);
+		const auto index = entryIndex<OD>(address);
+		if (!index || !entry(*index).isReadable()) return nullptr;
+		return &readHandlers[*index];
 	}
 
-	std::optional<WriteHandlerRT>
+	const WriteHandlerRT*
 	lookupWriteHandler(Address address) const
 	{
-		if (writeHandlers.count(address) == 0) return {};
-		return writeHandlers.at(address);
+		const auto index = entryIndex<OD>(address);
+		if (!index || !entry(*index).isWritable()) return nullptr;
+		return &writeHandlers[*index];
 	}
 
 	template<typename ReturnT>
 	void
-	setReadHandler(Address address, std::function<std::optional<ReturnT>()> func)
+	setReadHandler(Address address, ReadFunctionRT<ReturnT> func)
 	{
-		ReadHandlerRT handler = func;
-		auto entry = OD::map.lookup(address);
-		if (!entry)
+		const auto index = entryIndex<OD>(address);
+		if (!index)
 		{
 			MODM_LOG_ERROR << "Object not found" << modm::hex << address.index << modm::ascii << ":"
 						   << address.subindex << modm::endl;
 			abort();
 		}
 
-		bool accessValid = entry->isReadable();
-		if (!accessValid)
+		const auto& odEntry = entry(*index);
+		if (!odEntry.isReadable())
 		{
 			MODM_LOG_ERROR << "Cannot register read handler for write-only object " << modm::hex
 						   << address.index << modm::ascii << ":" << address.subindex << modm::endl;
 			abort();
 		}
 
-		auto handlerIndex = ReadHandlerRT(std::function<std::optional<ReturnT>()>()).index();
-		auto odIndex = static_cast<std::size_t>(entry->dataType);
-		if (odIndex != handlerIndex)
+		ReadHandlerRT handler{std::move(func)};
+		if (handler.index() != static_cast<std::size_t>(odEntry.dataType))
 		{
 			MODM_LOG_ERROR << "Invalid read handler type for entry " << modm::hex << address.index
 						   << modm::ascii << ":" << address.subindex << modm::endl;
 			abort();
 		}
 
-		readHandlers[address] = handler;
+		readHandlers[*index] = std::move(handler);
 	}
 
 	template<typename Param>
 	void
-	setWriteHandler(Address address, std::function<SdoErrorCode(Param)> func)
+	setWriteHandler(Address address, WriteFunctionRT<Param> func)
 	{
-		WriteHandlerRT handler = func;
-		auto entry = OD::map.lookup(address);
-		if (!entry)
+		const auto index = entryIndex<OD>(address);
+		if (!index)
 		{
 			MODM_LOG_ERROR << "Object not found" << modm::hex << address.index << modm::ascii << ":"
 						   << address.subindex << modm::endl;
 			abort();
 		}
-		bool accessValid = entry->isWritable();
-		if (!accessValid)
+
+		const auto& odEntry = entry(*index);
+		if (!odEntry.isWritable())
 		{
 			MODM_LOG_ERROR << "Cannot register write handler for read-only object " << modm::hex
 						   << address.index << modm::ascii << ":" << address.subindex << modm::endl;
 			abort();
 		}
 
-		auto handlerIndex = WriteHandlerRT(std::function<SdoErrorCode(Param)>()).index();
-		auto odIndex = static_cast<std::size_t>(entry->dataType);
-		if (odIndex != handlerIndex)
+		WriteHandlerRT handler{std::move(func)};
+		if (handler.index() != static_cast<std::size_t>(odEntry.dataType))
 		{
 			MODM_LOG_ERROR << "Invalid write handler type for entry " << modm::hex << address.index
 						   << modm::ascii << ":" << address.subindex << modm::endl;
 			abort();
 		}
 
-		writeHandlers[address] = handler;
+		writeHandlers[*index] = std::move(handler);
 	}
 };
 
 inline std::optional<Value>
-callReadHandler(ReadHandlerRT h)
+callReadHandler(const ReadHandlerRT& h)
 {
 	static_assert(Value(std::monostate{}).index() == size_t(DataType::Empty));
 
@@ -207,7 +193,7 @@ callReadHandler(ReadHandlerRT h)
 }
 
 inline SdoErrorCode
-callWriteHandler(WriteHandlerRT h, Value value)
+callWriteHandler(const WriteHandlerRT& h, Value value)
 {
 	switch (DataType(h.index()))
 	{
@@ -0,0 +1,204 @@
+#include "heartbeat_consumer.hpp"
+
+#include <algorithm>
+
+namespace modm_canopen
+{
+
+void
+HeartbeatConsumer::setBootUpCallback(BootUpCallback&& callback)
+{
+	std::unique_lock lock(mutex_);
+	bootUpCallback_ = std::move(callback);
+}
+
+void
+HeartbeatConsumer::setStateChangeCallback(StateChangeCallback&& callback)
+{
+	std::unique_lock lock(mutex_);
+	stateChangeCallback_ = std::move(callback);
+}
+
+void
+HeartbeatConsumer::setHeartbeatLostCallback(HeartbeatLostCallback&& callback)
+{
+	std::unique_lock lock(mutex_);
+	heartbeatLostCallback_ = std::move(callback);
+}
+
+void
+HeartbeatConsumer::setConsumerTime(uint8_t nodeId, modm::PreciseClock::duration consumerTime)
+{
+	if (nodeId == 0 || nodeId > MaxNodeId) return;
+	std::unique_lock lock(mutex_);
+	auto& node = nodes_[nodeId];
+	node.consumerTime = consumerTime;
+	unschedule(nodeId);
+	if (node.state && !node.heartbeatLost) { schedule(nodeId); }
+}
+
+bool
+HeartbeatConsumer::processMessage(const modm::can::Message& message,
+								  modm::PreciseClock::time_point now)
+{
+	const uint32_t id = message.getIdentifier();
+	if (id <= 0x700 || id > 0x700u + MaxNodeId) return false;
+	// Node guarding requests share the identifier
+	if (message.isRemoteTransmitRequest() || message.getLength() != 1) return false;
+
+	// Bit 7 is the node guarding toggle bit
+	const auto state = toNMTState(message.data[0] & 0x7F);
+	if (!state) return false;
+
+	const uint8_t nodeId = id - 0x700;
+	std::optional<NMTState> oldState{};
+	{
+		std::unique_lock lock(mutex_);
+		start(now);
+		auto& node = nodes_[nodeId];
+		oldState = node.state;
+		node.state = state;
+		node.heartbeatLost = false;
+		node.lastHeartbeat = now;
+		unschedule(nodeId);
+		schedule(nodeId);
+	}
+
+	if (*state == NMTState::BootUp)
+	{
+		if (bootUpCallback_) { bootUpCallback_(nodeId); }
+	} else if (oldState && *oldState != *state)
+	{
+		if (stateChangeCallback_) { stateChangeCallback_(nodeId, *oldState, *state); }
+	}
+	return true;
+}
+
+void
+HeartbeatConsumer::update(modm::PreciseClock::time_point now)
+{
+	std::array<uint8_t, MaxNodeId> lost{};
+	std::size_t lostCount = 0;
+	{
+		std::unique_lock lock(mutex_);
+		start(now);
+		const int64_t nowTick = toTick(now);
+
+		// The current slot is visited again on the next call, it may hold deadlines later in the
+		// same tick. A gap longer than a full revolution visits every slot exactly once.
+		const int64_t steps = std::min<int64_t>(nowTick - currentTick_ + 1, WheelSize);
+		for (int64_t step = 0; step < steps; ++step)
+		{
+			uint8_t nodeId = slots_[(currentTick_ + step) % WheelSize];
+			while (nodeId != None)
+			{
+				const uint8_t next = links_[nodeId].next;
+				// Entries of later revolutions share the slot and stay in place
+				if (isExpired(nodeId, now))
+				{
+					unschedule(nodeId);
+					nodes_[nodeId].heartbeatLost = true;
+					lost[lostCount++] = nodeId;
+				}
+				nodeId = next;
+			}
+		}
+		if (nowTick > currentTick_)
+		{
+			currentTickTime_ += (nowTick - currentTick_) * SignedDuration{TickWidth};
+			currentTick_ = nowTick;
+		}
+	}
+
+	if (heartbeatLostCallback_)
+	{
+		for (std::size_t i = 0; i < lostCount; ++i) { heartbeatLostCallback_(lost[i]); }
+	}
+}
+
+auto
+HeartbeatConsumer::nodeStatus(uint8_t nodeId) const -> NodeStatus
+{
+	if (nodeId == 0 || nodeId > MaxNodeId) return {};
+	std::unique_lock lock(mutex_);
+	return nodes_[nodeId];
+}
+
+auto
+HeartbeatConsumer::nodeStates() const -> std::array<NodeStatus, MaxNodeId + 1>
+{
+	std::unique_lock lock(mutex_);
+	return nodes_;
+}
+
+auto
+HeartbeatConsumer::elapsed(modm::PreciseClock::time_point from, modm::PreciseClock::time_point to)
+	-> SignedDuration
+{
+	using Rep = modm::PreciseClock::rep;
+	return SignedDuration{std::make_signed_t<Rep>((to - from).count())};
+}
+
+void
+HeartbeatConsumer::start(modm::PreciseClock::time_point now)
+{
+	if (started_) return;
+	started_ = true;
+	currentTick_ = 0;
+	currentTickTime_ = now;
+}
+
+int64_t
+HeartbeatConsumer::toTick(modm::PreciseClock::time_point time) const
+{
+	const auto delta = elapsed(currentTickTime_, time);
+	const SignedDuration width{TickWidth};
+	// Round towards negative infinity, time may lie before the current tick
+	int64_t ticks = delta / width;
+	if (delta % width < SignedDuration{0}) { --ticks; }
+	return currentTick_ + ticks;
+}
+
+bool
+HeartbeatConsumer::isExpired(uint8_t nodeId, modm::PreciseClock::time_point now) const
+{
+	const auto& node = nodes_[nodeId];
+	return elapsed(node.lastHeartbeat, now) >= node.consumerTime;
+}
+
+void
+HeartbeatConsumer::schedule(uint8_t nodeId)
+{
+	const auto& node = nodes_[nodeId];
+	if (node.consumerTime.count() == 0) return;
+
+	// Overdue deadlines go into the current slot, otherwise they would wait a whole revolution
+	const int64_t tick =
+		std::max(toTick(node.lastHeartbeat + node.consumerTime), currentTick_);
+	auto& link = links_[nodeId];
+	link.slot = tick % WheelSize;
+	link.prev = None;
+	link.next = slots_[link.slot];
+	if (link.next != None) { links_[link.next].prev = nodeId; }
+	slots_[link.slot] = nodeId;
+	link.scheduled = true;
+}
+
+void
+HeartbeatConsumer::unschedule(uint8_t nodeId)
+{
+	auto& link = links_[nodeId];
+	if (!link.scheduled) return;
+
+	if (link.prev != None)
+	{
+		links_[link.prev].next = link.next;
+	} else
+	{
+		slots_[link.slot] = link.next;
+	}
+	if (link.next != None) { links_[link.next].prev = link.prev; }
+	link = Link{};
+}
+
+}  // namespace modm_canopen
@@ -0,0 +1,114 @@
+#ifndef CANOPEN_HEARTBEAT_CONSUMER_HPP
+#define CANOPEN_HEARTBEAT_CONSUMER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+#include <modm/architecture/interface/can_message.hpp>
+#include <modm/processing/timer.hpp>
+
+#include "../nmt_state.hpp"
+
+namespace modm_canopen
+{
+
+/// Tracks NMT state and heartbeat deadlines of all nodes on the bus.
+/// Deadlines are kept in a hashed timer wheel with intrusive per-slot lists, so a heartbeat frame
+/// refreshes its node in O(1) and update() only visits the slots that elapsed since the last call.
+class HeartbeatConsumer
+{
+public:
+	static constexpr uint8_t MaxNodeId = 127;
+	static constexpr modm::PreciseClock::duration TickWidth{std::chrono::milliseconds{1}};
+	static constexpr std::size_t WheelSize = 1024;
+
+	struct NodeStatus
+	{
+		std::optional<NMTState> state{};  // empty until the first heartbeat was received
+		bool heartbeatLost{false};
+		modm::PreciseClock::time_point lastHeartbeat{};
+		modm::PreciseClock::duration consumerTime{0};
+	};
+
+	using BootUpCallback = std::function<void(uint8_t nodeId)>;
+	using StateChangeCallback =
+		std::function<void(uint8_t nodeId, NMTState oldState, NMTState newState)>;
+	using HeartbeatLostCallback = std::function<void(uint8_t nodeId)>;
+
+	/// Callbacks are invoked without the internal lock held. Set them before the bus is running.
+	void
+	setBootUpCallback(BootUpCallback&& callback);
+	void
+	setStateChangeCallback(StateChangeCallback&& callback);
+	void
+	setHeartbeatLostCallback(HeartbeatLostCallback&& callback);
+
+	/// A consumer time of 0 disables heartbeat monitoring for that node, its state is still tracked
+	void
+	setConsumerTime(uint8_t nodeId, modm::PreciseClock::duration consumerTime);
+
+	/// Returns true if the message was a heartbeat or boot-up frame
+	bool
+	processMessage(const modm::can::Message& message,
+				   modm::PreciseClock::time_point now = modm::PreciseClock::now());
+
+	void
+	update(modm::PreciseClock::time_point now = modm::PreciseClock::now());
+
+	NodeStatus
+	nodeStatus(uint8_t nodeId) const;
+
+	/// Snapshot of the whole table, indexed by node id. Index 0 is unused.
+	std::array<NodeStatus, MaxNodeId + 1>
+	nodeStates() const;
+
+private:
+	// Node id 0 is not a valid node, so it doubles as the end-of-list marker
+	static constexpr uint8_t None = 0;
+
+	struct Link
+	{
+		uint8_t next{None};
+		uint8_t prev{None};
+		uint16_t slot{0};
+		bool scheduled{false};
+	};
+
+	using SignedDuration = std::chrono::duration<int64_t, modm::PreciseClock::period>;
+
+	static SignedDuration
+	elapsed(modm::PreciseClock::time_point from, modm::PreciseClock::time_point to);
+
+	void
+	start(modm::PreciseClock::time_point now);
+	int64_t
+	toTick(modm::PreciseClock::time_point time) const;
+	bool
+	isExpired(uint8_t nodeId, modm::PreciseClock::time_point now) const;
+
+	void
+	schedule(uint8_t nodeId);
+	void
+	unschedule(uint8_t nodeId);
+
+	mutable std::mutex mutex_{};
+	std::array<NodeStatus, MaxNodeId + 1> nodes_{};
+	std::array<Link, MaxNodeId + 1> links_{};
+	std::array<uint8_t, WheelSize> slots_{};
+	// PreciseClock wraps around, so ticks are counted relative to the start of the current tick
+	int64_t currentTick_{0};
+	modm::PreciseClock::time_point currentTickTime_{};
+	bool started_{false};
+
+	BootUpCallback bootUpCallback_{};
+	StateChangeCallback stateChangeCallback_{};
+	HeartbeatLostCallback heartbeatLostCallback_{};
+};
+
+}  // namespace modm_canopen
+
+#endif  // CANOPEN_HEARTBEAT_CONSUMER_HPP
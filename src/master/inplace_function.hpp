@@ -0,0 +1,120 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace modm_canopen
+{
+
+template<typename Signature, std::size_t Capacity = 4 * sizeof(void*)>
+class InplaceFunction;
+
+/// Type-erased callable like std::function, but the callable is always stored inline.
+/// Copying and calling never allocate, callables larger than Capacity are rejected at compile time.
+template<typename R, typename... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+public:
+	InplaceFunction() = default;
+	InplaceFunction(std::nullptr_t) {}
+
+	template<typename F>
+		requires(!std::is_same_v<std::remove_cvref_t<F>, InplaceFunction> &&
+				 std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+	InplaceFunction(F&& function)
+	{
+		using Callable = std::decay_t<F>;
+		static_assert(sizeof(Callable) <= Capacity,
+					  "Callable too large for InplaceFunction, capture a pointer instead");
+		static_assert(alignof(Callable) <= alignof(std::max_align_t));
+		::new (static_cast<void*>(storage_)) Callable(std::forward<F>(function));
+		operations_ = &OperationsFor<Callable>;
+	}
+
+	InplaceFunction(const InplaceFunction& other) : operations_{other.operations_}
+	{
+		if (operations_) { operations_->copy(storage_, other.storage_); }
+	}
+
+	InplaceFunction(InplaceFunction&& other) noexcept : operations_{other.operations_}
+	{
+		if (operations_) { operations_->move(storage_, other.storage_); }
+	}
+
+	InplaceFunction&
+	operator=(const InplaceFunction& other)
+	{
+		if (this != &other)
+		{
+			reset();
+			if (other.operations_) { other.operations_->copy(storage_, other.storage_); }
+			operations_ = other.operations_;
+		}
+		return *this;
+	}
+
+	InplaceFunction&
+	operator=(InplaceFunction&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			if (other.operations_) { other.operations_->move(storage_, other.storage_); }
+			operations_ = other.operations_;
+		}
+		return *this;
+	}
+
+	~InplaceFunction() { reset(); }
+
+	explicit
+	operator bool() const
+	{
+		return operations_ != nullptr;
+	}
+
+	R
+	operator()(Args... args) const
+	{
+		if (!operations_) { throw std::bad_function_call{}; }
+		return operations_->invoke(storage_, std::forward<Args>(args)...);
+	}
+
+private:
+	struct Operations
+	{
+		R (*invoke)(void*, Args&&...);
+		void (*copy)(void*, const void*);
+		void (*move)(void*, void*);
+		void (*destroy)(void*);
+	};
+
+	template<typename Callable>
+	static constexpr Operations OperationsFor{
+		[](void* callable, Args&&... args) -> R {
+			return std::invoke(*static_cast<Callable*>(callable), std::forward<Args>(args)...);
+		},
+		[](void* to, const void* from) {
+			::new (to) Callable(*static_cast<const Callable*>(from));
+		},
+		[](void* to, void* from) {
+			::new (to) Callable(std::move(*static_cast<Callable*>(from)));
+		},
+		[](void* callable) { static_cast<Callable*>(callable)->~Callable(); },
+	};
+
+	void
+	reset()
+	{
+		if (operations_) { operations_->destroy(storage_); }
+		operations_ = nullptr;
+	}
+
+	// Mutable like the target of std::function, operator() is const but the callable may not be
+	alignas(std::max_align_t) mutable std::byte storage_[Capacity];
+	const Operations* operations_{nullptr};
+};
+
+}  // namespace modm_canopen
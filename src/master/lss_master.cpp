@@ -0,0 +1,290 @@
+#include "lss_master.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <modm/debug/logger.hpp>
+
+namespace modm_canopen
+{
+
+void
+LssMaster::setResponseTimeout(modm::PreciseClock::duration timeout)
+{
+	std::unique_lock lock(mutex_);
+	timeout_ = timeout;
+}
+
+void
+LssMaster::setKnownAddress(const std::array<std::optional<uint32_t>, 4>& known)
+{
+	std::unique_lock lock(mutex_);
+	known_ = known;
+}
+
+void
+LssMaster::setNodeConfiguredCallback(NodeConfiguredCallback&& callback)
+{
+	std::unique_lock lock(mutex_);
+	nodeConfiguredCallback_ = std::move(callback);
+}
+
+void
+LssMaster::setScanFinishedCallback(ScanFinishedCallback&& callback)
+{
+	std::unique_lock lock(mutex_);
+	scanFinishedCallback_ = std::move(callback);
+}
+
+bool
+LssMaster::startFastScan(NodeIdAllocator&& allocator, bool storeConfiguration)
+{
+	std::unique_lock lock(mutex_);
+	if (state_ != State::Idle) return false;
+	allocator_ = std::move(allocator);
+	storeConfiguration_ = storeConfiguration;
+	configuredNodes_ = 0;
+	awaiting_ = false;
+	state_ = State::Reset;
+	return true;
+}
+
+bool
+LssMaster::startFastScan(uint8_t firstNodeId, bool storeConfiguration)
+{
+	return startFastScan(
+		[next = firstNodeId](const LssAddress&) mutable -> std::optional<uint8_t> {
+			if (next == 0 || next > 127) return std::nullopt;
+			return next++;
+		},
+		storeConfiguration);
+}
+
+bool
+LssMaster::isScanning() const
+{
+	std::unique_lock lock(mutex_);
+	return state_ != State::Idle;
+}
+
+bool
+LssMaster::processMessage(const modm::can::Message& message)
+{
+	if (message.getIdentifier() != LssSlaveCobId || message.getLength() != 8) return false;
+
+	std::unique_lock lock(mutex_);
+	if (awaiting_ && message.data[0] == (uint8_t)expectedResponse())
+	{
+		// Several slaves may answer the same Fast Scan request, one answer is all we need
+		if (!responded_) { responseError_ = message.data[1]; }
+		responded_ = true;
+	}
+	return true;
+}
+
+std::optional<modm::can::Message>
+LssMaster::poll(modm::PreciseClock::time_point now)
+{
+	std::optional<modm::can::Message> message{};
+	std::optional<std::pair<LssAddress, uint8_t>> configured{};
+	bool finished = false;
+	uint8_t configuredNodes = 0;
+	NodeConfiguredCallback nodeConfiguredCallback{};
+	ScanFinishedCallback scanFinishedCallback{};
+	{
+		std::unique_lock lock(mutex_);
+		if (state_ == State::Idle) return {};
+
+		if (awaiting_)
+		{
+			// Proceed as soon as a slave answered, otherwise only after the timeout
+			if (!responded_ && now - sent_ < timeout_) return {};
+			awaiting_ = false;
+			advance(responded_);
+		}
+
+		if (state_ != State::Idle)
+		{
+			message = request();
+			sent_ = now;
+			responded_ = false;
+			responseError_ = 0;
+			awaiting_ = true;
+			// Switching to waiting state is not answered
+			if (state_ == State::SwitchToWaiting) { sent_ = now - timeout_; }
+		}
+
+		configured = std::exchange(configuredEvent_, std::nullopt);
+		finished = std::exchange(finishedEvent_, false);
+		configuredNodes = configuredNodes_;
+		nodeConfiguredCallback = nodeConfiguredCallback_;
+		scanFinishedCallback = scanFinishedCallback_;
+	}
+
+	if (configured && nodeConfiguredCallback)
+	{
+		nodeConfiguredCallback(configured->first, configured->second);
+	}
+	if (finished && scanFinishedCallback) { scanFinishedCallback(configuredNodes); }
+	return message;
+}
+
+void
+LssMaster::advance(bool responded)
+{
+	switch (state_)
+	{
+		case State::Reset:
+			// No unconfigured slave left
+			if (!responded)
+			{
+				finish();
+				return;
+			}
+			part_ = 0;
+			startPart();
+			return;
+		case State::ScanBit:
+			// No slave matches a 0 at this position, so all remaining ones have a 1
+			if (!responded) { address_[part_] |= (uint32_t(1) << bit_); }
+			if (bit_ == 0)
+			{
+				state_ = State::VerifyPart;
+			} else
+			{
+				--bit_;
+			}
+			return;
+		case State::VerifyPart: {
+			if (!responded)
+			{
+				MODM_LOG_ERROR << "LSS Fast Scan: no slave confirmed part " << (int)part_ << modm::endl;
+				finish();
+				return;
+			}
+			if (part_ < address_.size() - 1)
+			{
+				++part_;
+				startPart();
+				return;
+			}
+			// The slave switched to configuration state after the last part was confirmed
+			const auto nodeId = allocator_ ? allocator_(address_) : std::nullopt;
+			if (!nodeId)
+			{
+				finish();
+				return;
+			}
+			nodeId_ = *nodeId;
+			state_ = State::ConfigureNodeId;
+			return;
+		}
+		case State::ConfigureNodeId:
+			if (!responded || responseError_ != 0)
+			{
+				MODM_LOG_ERROR << "LSS: configuring node id " << (int)nodeId_ << " failed" << modm::endl;
+				finish();
+				return;
+			}
+			state_ = storeConfiguration_ ? State::StoreConfiguration : State::SwitchToWaiting;
+			return;
+		case State::StoreConfiguration:
+			if (!responded || responseError_ != 0)
+			{
+				MODM_LOG_ERROR << "LSS: storing node id " << (int)nodeId_ << " failed" << modm::endl;
+			}
+			state_ = State::SwitchToWaiting;
+			return;
+		case State::SwitchToWaiting:
+			// The slave is configured now and does not take part in the next scan
+			++configuredNodes_;
+			configuredEvent_ = std::make_pair(address_, nodeId_);
+			state_ = State::Reset;
+			return;
+		case State::Idle:
+			return;
+	}
+}
+
+void
+LssMaster::startPart()
+{
+	if (known_[part_])
+	{
+		address_[part_] = *known_[part_];
+		state_ = State::VerifyPart;
+		return;
+	}
+	address_[part_] = 0;
+	bit_ = 31;
+	state_ = State::ScanBit;
+}
+
+void
+LssMaster::finish()
+{
+	state_ = State::Idle;
+	finishedEvent_ = true;
+}
+
+modm::can::Message
+LssMaster::request() const
+{
+	modm::can::Message message{LssMasterCobId, 8};
+	message.setExtended(false);
+	std::fill(message.data, message.data + 8, 0);
+
+	auto setFastScan = [&message](uint32_t idNumber, uint8_t bitChecked, uint8_t sub,
+								  uint8_t next) {
+		message.data[0] = (uint8_t)LSSCommand::FastScan;
+		message.data[1] = idNumber & 0xFF;
+		message.data[2] = (idNumber >> 8) & 0xFF;
+		message.data[3] = (idNumber >> 16) & 0xFF;
+		message.data[4] = (idNumber >> 24) & 0xFF;
+		message.data[5] = bitChecked;
+		message.data[6] = sub;
+		message.data[7] = next;
+	};
+
+	switch (state_)
+	{
+		case State::Reset:
+			setFastScan(0, LssFastScanReset, 0, 0);
+			break;
+		case State::ScanBit:
+			setFastScan(address_[part_], bit_, part_, part_);
+			break;
+		case State::VerifyPart:
+			setFastScan(address_[part_], 0, part_, (part_ + 1) % address_.size());
+			break;
+		case State::ConfigureNodeId:
+			message.data[0] = (uint8_t)LSSCommand::ConfigureNodeId;
+			message.data[1] = nodeId_;
+			break;
+		case State::StoreConfiguration:
+			message.data[0] = (uint8_t)LSSCommand::StoreConfiguration;
+			break;
+		case State::SwitchToWaiting:
+			message.data[0] = (uint8_t)LSSCommand::SwitchStateGlobal;
+			message.data[1] = 0;
+			break;
+		case State::Idle:
+			break;
+	}
+	return message;
+}
+
+LSSCommand
+LssMaster::expectedResponse() const
+{
+	switch (state_)
+	{
+		case State::ConfigureNodeId:
+			return LSSCommand::ConfigureNodeId;
+		case State::StoreConfiguration:
+			return LSSCommand::StoreConfiguration;
+		default:
+			return LSSCommand::IdentifySlave;
+	}
+}
+
+}  // namespace modm_canopen
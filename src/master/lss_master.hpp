@@ -0,0 +1,119 @@
+#ifndef CANOPEN_LSS_MASTER_HPP
+#define CANOPEN_LSS_MASTER_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+#include <modm/architecture/interface/can_message.hpp>
+#include <modm/processing/timer.hpp>
+
+#include "../lss_command.hpp"
+
+namespace modm_canopen
+{
+
+/// CiA 305 LSS master that finds unconfigured slaves with Fast Scan and assigns node ids.
+/// Every bit of the 128 bit LSS address costs one request, a request only waits for the full
+/// response timeout if no slave answers. update() has to be called at least once per timeout.
+class LssMaster
+{
+public:
+	/// Returns the node id for a found slave, std::nullopt ends the scan
+	using NodeIdAllocator = std::function<std::optional<uint8_t>(const LssAddress&)>;
+	using NodeConfiguredCallback = std::function<void(const LssAddress&, uint8_t nodeId)>;
+	using ScanFinishedCallback = std::function<void(uint8_t configuredNodes)>;
+
+	void
+	setResponseTimeout(modm::PreciseClock::duration timeout);
+
+	/// Known parts of the LSS address (e.g. vendor id and product code) are only verified instead
+	/// of scanned bit by bit
+	void
+	setKnownAddress(const std::array<std::optional<uint32_t>, 4>& known);
+
+	void
+	setNodeConfiguredCallback(NodeConfiguredCallback&& callback);
+	void
+	setScanFinishedCallback(ScanFinishedCallback&& callback);
+
+	/// Returns false if a scan is already running
+	bool
+	startFastScan(NodeIdAllocator&& allocator, bool storeConfiguration = false);
+
+	/// Assigns consecutive node ids starting at firstNodeId
+	bool
+	startFastScan(uint8_t firstNodeId, bool storeConfiguration = false);
+
+	bool
+	isScanning() const;
+
+	/// Returns true if the message was an LSS response
+	bool
+	processMessage(const modm::can::Message& message);
+
+	template<typename MessageCallback>
+	void
+	update(MessageCallback&& sendMessage)
+	{
+		const auto message = poll(modm::PreciseClock::now());
+		if (message) { sendMessage(*message); }
+	}
+
+private:
+	enum class State : uint8_t
+	{
+		Idle,
+		Reset,
+		ScanBit,
+		VerifyPart,
+		ConfigureNodeId,
+		StoreConfiguration,
+		SwitchToWaiting,
+	};
+
+	std::optional<modm::can::Message>
+	poll(modm::PreciseClock::time_point now);
+
+	void
+	advance(bool responded);
+	void
+	startPart();
+	void
+	finish();
+	modm::can::Message
+	request() const;
+	LSSCommand
+	expectedResponse() const;
+
+	mutable std::mutex mutex_{};
+	State state_{State::Idle};
+	modm::PreciseClock::duration timeout_{std::chrono::milliseconds{2}};
+	std::array<std::optional<uint32_t>, 4> known_{};
+
+	bool awaiting_{false};
+	bool responded_{false};
+	uint8_t responseError_{0};
+	modm::PreciseClock::time_point sent_{};
+
+	LssAddress address_{};
+	uint8_t part_{0};
+	uint8_t bit_{0};
+	uint8_t nodeId_{0};
+	uint8_t configuredNodes_{0};
+	bool storeConfiguration_{false};
+
+	// Events are reported from update() after the lock was released
+	std::optional<std::pair<LssAddress, uint8_t>> configuredEvent_{};
+	bool finishedEvent_{false};
+
+	NodeIdAllocator allocator_{};
+	NodeConfiguredCallback nodeConfiguredCallback_{};
+	ScanFinishedCallback scanFinishedCallback_{};
+};
+
+}  // namespace modm_canopen
+
+#endif  // CANOPEN_LSS_MASTER_HPP
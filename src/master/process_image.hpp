@@ -0,0 +1,106 @@
+#ifndef CANOPEN_PROCESS_IMAGE_HPP
+#define CANOPEN_PROCESS_IMAGE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#include "../object_dictionary.hpp"
+
+namespace modm_canopen
+{
+
+/// Last value of every object of a node, as received from it or set by the application.
+/// Values are kept as raw bits in atomics indexed like OD::map, PDO reception and application
+/// threads need no lock. Typed access resolves the index at compile time.
+template<typename OD>
+class ProcessImage
+{
+public:
+	static constexpr std::size_t Size = OD::map.size();
+
+	void
+	store(Address address, const Value& value)
+	{
+		const auto index = entryIndex<OD>(address);
+		if (!index || value.index() != static_cast<std::size_t>(entry(*index).dataType)) return;
+		std::array<uint8_t, sizeof(uint64_t)> bytes{};
+		valueToBytes(value, bytes);
+		uint64_t bits;
+		std::memcpy(&bits, bytes.data(), sizeof(bits));
+		storeBits(*index, bits);
+	}
+
+	std::optional<Value>
+	load(Address address) const
+	{
+		const auto index = entryIndex<OD>(address);
+		if (!index) return {};
+		const auto bits = loadBits(*index);
+		if (!bits) return {};
+		std::array<uint8_t, sizeof(uint64_t)> bytes;
+		std::memcpy(bytes.data(), &*bits, sizeof(*bits));
+		return valueFromBytes(entry(*index).dataType, bytes);
+	}
+
+	template<typename Object>
+	void
+	store(typename Object::Type value)
+	{
+		uint64_t bits{};
+		std::memcpy(&bits, &value, sizeof(value));
+		storeBits(index<Object>(), bits);
+	}
+
+	template<typename Object>
+	std::optional<typename Object::Type>
+	load() const
+	{
+		const auto bits = loadBits(index<Object>());
+		if (!bits) return {};
+		typename Object::Type value;
+		std::memcpy(&value, &*bits, sizeof(value));
+		return value;
+	}
+
+private:
+	static constexpr const Entry&
+	entry(std::size_t index)
+	{
+		return (OD::map.begin() + index)->second;
+	}
+
+	template<typename Object>
+	static constexpr std::size_t
+	index()
+	{
+		constexpr auto position = entryIndex<OD>(Object::address);
+		static_assert(position.has_value(), "Object is not in the object dictionary");
+		static_assert(entry(*position).dataType == Object::dataType,
+					  "Object type does not match OD");
+		return *position;
+	}
+
+	void
+	storeBits(std::size_t index, uint64_t bits)
+	{
+		values_[index].store(bits, std::memory_order_relaxed);
+		valid_[index].store(true, std::memory_order_release);
+	}
+
+	std::optional<uint64_t>
+	loadBits(std::size_t index) const
+	{
+		if (!valid_[index].load(std::memory_order_acquire)) return {};
+		return values_[index].load(std::memory_order_relaxed);
+	}
+
+	std::array<std::atomic<uint64_t>, Size> values_{};
+	std::array<std::atomic<bool>, Size> valid_{};
+};
+
+}  // namespace modm_canopen
+
+#endif  // CANOPEN_PROCESS_IMAGE_HPP
@@ -2,7 +2,10 @@
 #define CANOPEN_SDO_CLIENT_HPP
 #include <modm/architecture/interface/can_message.hpp>
 #include "../object_dictionary.hpp"
+#include <bitset>
+#include <deque>
 #include <future>
+#include <span>
 #include <vector>
 #include <cstdint>
 #include <functional>
@@ -12,41 +15,69 @@
 
 namespace modm_canopen
 {
+
+struct NodeAddress
+{
+	uint8_t nodeId;
+	Address address;
+};
+
 // Needs a heap allocator, could be changed, but im only planning on using it on a linux host
 template<typename Device>
 class SdoClient
 {
 public:
+	explicit SdoClient(Device& device) : device_(device) {}
+
 	template<typename MessageCallback>
-	static void
+	void
 	requestRead(uint8_t canId, Address address, MessageCallback&& sendMessage);
 
 	template<typename MessageCallback>
-	static void
+	void
 	requestRead(uint8_t canId, Address address,
 				std::function<void(const uint8_t, Value)>&& valueCallback,
 				MessageCallback&& sendMessage);
 
+	/// Decodes the response as dataType instead of using the object dictionary of the node, for
+	/// objects the local dictionary does not describe
+	template<typename MessageCallback>
+	void
+	requestRead(uint8_t canId, Address address, DataType dataType,
+				std::function<void(const uint8_t, Value)>&& valueCallback,
+				MessageCallback&& sendMessage);
+
 	template<typename MessageCallback>
-	static bool
+	bool
 	requestWrite(uint8_t canId, Address address, MessageCallback&& sendMessage);
 
 	template<typename MessageCallback>
-	static void
+	void
 	requestWrite(uint8_t canId, Address address, const Value& value, MessageCallback&& sendMessage);
 
+	/// Pipelined uploads: one transfer per node is in flight at a time, transfers to different
+	/// nodes overlap. The next transfer to a node is sent from update() after its response.
+	template<typename MessageCallback>
+	void
+	requestReadMany(std::span<const NodeAddress> objects, MessageCallback&& sendMessage);
+
+	template<typename MessageCallback>
+	void
+	requestWriteMany(std::span<const NodeAddress> objects, std::span<const Value> values,
+					 MessageCallback&& sendMessage);
+
 	template<typename MessageCallback>
-	static void
+	void
 	processMessage(const modm::can::Message& request, MessageCallback&& responseCallback);
 
 	template<typename MessageCallback>
-	static void
+	void
 	update(MessageCallback&& sendMessage);
 
-	static bool
+	bool
 	waiting();
 
-	static bool
+	bool
 	waitingOn(uint8_t id);
 
 private:
@@ -59,6 +90,7 @@ private:
 		modm::Clock::time_point sent;
 		modm::can::Message msg;
 		std::function<void(const uint8_t, Value)> callback;
+		std::optional<DataType> dataType;
 
 		inline WaitingEntry()
 		{
@@ -68,6 +100,7 @@ private:
 			sent = {};
 			msg = {};
 			callback = {};
+			dataType = {};
 		}
 
 		inline WaitingEntry&
@@ -79,6 +112,7 @@ private:
 			sent = other.sent;
 			msg = other.msg;
 			callback = other.callback;
+			dataType = other.dataType;
 			return *this;
 		}
 
@@ -90,6 +124,7 @@ private:
 			sent = other.sent;
 			msg = other.msg;
 			callback = other.callback;
+			dataType = other.dataType;
 		};
 
 		inline WaitingEntry&
@@ -101,6 +136,7 @@ private:
 			sent = std::move(other.sent);
 			msg = std::move(other.msg);
 			callback = std::move(other.callback);
+			dataType = std::move(other.dataType);
 			return *this;
 		};
 
@@ -112,18 +148,28 @@ private:
 			sent = std::move(other.sent);
 			msg = std::move(other.msg);
 			callback = std::move(other.callback);
+			dataType = std::move(other.dataType);
 		};
 	};
 
-	static inline std::mutex waitingOnMutex_;
-	static std::vector<WaitingEntry> waitingOn_;
+	Device& device_;
+
+	std::mutex waitingOnMutex_;
+	std::vector<WaitingEntry> waitingOn_{};
+	// Batched transfers not sent yet, in request order
+	std::deque<WaitingEntry> queued_{};
+
+	template<typename MessageCallback>
+	void
+	sendQueued(MessageCallback&& sendMessage);
 
-	static void
+	void
 	addWaitingEntry(uint8_t canId, Address address, bool isRead, const modm::can::Message& msg);
 
-	static void
+	void
 	addWaitingEntry(uint8_t canId, Address address, bool isRead, const modm::can::Message& msg,
-					std::function<void(const uint8_t, Value)>&& func);
+					std::function<void(const uint8_t, Value)>&& func,
+					std::optional<DataType> dataType = {});
 };
 
 namespace detail
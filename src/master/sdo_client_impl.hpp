@@ -5,9 +5,6 @@
 namespace modm_canopen
 {
 using namespace std::literals;
-template<typename Device>
-std::vector<typename SdoClient<Device>::WaitingEntry> SdoClient<Device>::waitingOn_{};
-
 template<typename Device>
 template<typename MessageCallback>
 void
@@ -15,16 +12,90 @@ SdoClient<Device>::update(MessageCallback&& sendMessage)
 {
 	constexpr modm::Clock::duration timeout{100ms};
 	auto now = modm::Clock::now();
+	{
+		std::unique_lock lock(waitingOnMutex_);
+		for (auto& wait : waitingOn_)
+		{
+			auto timesince = now - wait.sent;
+			if (timesince > timeout)
+			{
+				sendMessage(wait.msg);
+				wait.sent = now;
+			}
+		}
+	}
+	sendQueued(sendMessage);
+}
+
+template<typename Device>
+template<typename MessageCallback>
+void
+SdoClient<Device>::sendQueued(MessageCallback&& sendMessage)
+{
 	std::unique_lock lock(waitingOnMutex_);
-	for (auto& wait : waitingOn_)
+	if (queued_.empty()) return;
+
+	std::bitset<128> busy{};
+	for (const auto& wait : waitingOn_) { busy.set(wait.canId & 0x7F); }
+
+	const auto now = modm::Clock::now();
+	for (auto it = queued_.begin(); it != queued_.end();)
+	{
+		// Later transfers to a busy node stay queued behind the first one
+		if (busy.test(it->canId & 0x7F))
+		{
+			++it;
+			continue;
+		}
+		busy.set(it->canId & 0x7F);
+		it->sent = now;
+		sendMessage(it->msg);
+		waitingOn_.push_back(std::move(*it));
+		it = queued_.erase(it);
+	}
+}
+
+template<typename Device>
+template<typename MessageCallback>
+void
+SdoClient<Device>::requestReadMany(std::span<const NodeAddress> objects,
+								   MessageCallback&& sendMessage)
+{
 	{
-		auto timesince = now - wait.sent;
-		if (timesince > timeout)
+		std::unique_lock lock(waitingOnMutex_);
+		for (const auto& object : objects)
 		{
-			sendMessage(wait.msg);
-			wait.sent = now;
+			WaitingEntry entry{};
+			entry.canId = object.nodeId;
+			entry.address = object.address;
+			entry.isRead = true;
+			detail::uploadMessage(object.nodeId, object.address, entry.msg);
+			queued_.push_back(std::move(entry));
 		}
 	}
+	sendQueued(sendMessage);
+}
+
+template<typename Device>
+template<typename MessageCallback>
+void
+SdoClient<Device>::requestWriteMany(std::span<const NodeAddress> objects,
+									std::span<const Value> values, MessageCallback&& sendMessage)
+{
+	{
+		std::unique_lock lock(waitingOnMutex_);
+		const auto count = std::min(objects.size(), values.size());
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			WaitingEntry entry{};
+			entry.canId = objects[i].nodeId;
+			entry.address = objects[i].address;
+			entry.isRead = false;
+			detail::downloadMessage(objects[i].nodeId, objects[i].address, values[i], entry.msg);
+			queued_.push_back(std::move(entry));
+		}
+	}
+	sendQueued(sendMessage);
 }
 
 template<typename Device>
@@ -66,13 +137,14 @@ SdoClient<Device>::processMessage(const modm::can::Message& request,
 				SdoErrorCode error = SdoErrorCode::NoError;
 				if (it->callback)
 				{
-					auto val = Device::toValue(it->canId, address,
-											   std::span<const uint8_t>{&request.data[4], 4}, size);
+					const std::span<const uint8_t> data{&request.data[4], 4};
+					auto val = it->dataType ? std::optional{valueFromBytes(*it->dataType, data)}
+											: device_.toValue(it->canId, address, data, size);
 					if (val) { it->callback(it->canId, *val); }
 				} else
 				{
-					error = Device::write(it->canId, address,
-										  std::span<const uint8_t>{&request.data[4], 4}, size);
+					error = device_.write(it->canId, address,
+										 std::span<const uint8_t>{&request.data[4], 4}, size);
 				}
 				std::forward<MessageCallback>(responseCallback)(it->canId, address, error);
 				waitingOn_.erase(it);
@@ -121,12 +193,25 @@ SdoClient<Device>::requestRead(uint8_t canId, Address address,
 	sendMessage(msg);
 }
 
+template<typename Device>
+template<typename MessageCallback>
+void
+SdoClient<Device>::requestRead(uint8_t canId, Address address, DataType dataType,
+							   std::function<void(const uint8_t, Value)>&& valueCallback,
+							   MessageCallback&& sendMessage)
+{
+	modm::can::Message msg;
+	detail::uploadMessage(canId, address, msg);
+	addWaitingEntry(canId, address, true, msg, std::move(valueCallback), dataType);
+	sendMessage(msg);
+}
+
 template<typename Device>
 template<typename MessageCallback>
 bool
 SdoClient<Device>::requestWrite(uint8_t canId, Address address, MessageCallback&& sendMessage)
 {
-	auto value = Device::read(canId, address);
+	auto value = device_.read(canId, address);
 	if (std::holds_alternative<Value>(value))
 	{
 		modm::can::Message msg;
@@ -170,7 +255,8 @@ template<typename Device>
 void
 SdoClient<Device>::addWaitingEntry(uint8_t canId, Address address, bool isRead,
 								   const modm::can::Message& msg,
-								   std::function<void(const uint8_t, Value)>&& func)
+								   std::function<void(const uint8_t, Value)>&& func,
+								   std::optional<DataType> dataType)
 {
 	WaitingEntry entry{};
 	entry.canId = canId;
@@ -179,6 +265,7 @@ SdoClient<Device>::addWaitingEntry(uint8_t canId, Address address, bool isRead,
 	entry.sent = modm::Clock::now();
 	entry.msg = msg;
 	entry.callback = std::move(func);
+	entry.dataType = dataType;
 	std::unique_lock lock(waitingOnMutex_);
 	waitingOn_.push_back(entry);
 }
@@ -188,7 +275,7 @@ bool
 SdoClient<Device>::waiting()
 {
 	std::unique_lock lock(waitingOnMutex_);
-	return !waitingOn_.empty();
+	return !waitingOn_.empty() || !queued_.empty();
 }
 
 template<typename Device>
@@ -200,6 +287,10 @@ SdoClient<Device>::waitingOn(uint8_t id)
 	{
 		if (entry.canId == id) return true;
 	}
+	for (auto& entry : queued_)
+	{
+		if (entry.canId == id) return true;
+	}
 	return false;
 }
 
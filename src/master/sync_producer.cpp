@@ -0,0 +1,208 @@
+#include "sync_producer.hpp"
+
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <modm/debug/logger.hpp>
+
+namespace modm_canopen
+{
+
+namespace
+{
+int64_t
+monotonicNow()
+{
+	timespec ts{};
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return int64_t(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+timespec
+toTimespec(int64_t ns)
+{
+	return timespec{.tv_sec = time_t(ns / 1'000'000'000), .tv_nsec = long(ns % 1'000'000'000)};
+}
+}  // namespace
+
+void
+SyncJitterStatistics::record(std::chrono::nanoseconds lateness)
+{
+	const int64_t ns = std::max<int64_t>(lateness.count(), 0);
+	// Single writer, so plain load/store is sufficient for min/max
+	if (ns < min_.load(std::memory_order_relaxed)) { min_.store(ns, std::memory_order_relaxed); }
+	if (ns > max_.load(std::memory_order_relaxed)) { max_.store(ns, std::memory_order_relaxed); }
+	sum_.fetch_add(ns, std::memory_order_relaxed);
+
+	const auto index = std::min<std::size_t>(ns / BucketWidth.count(), BucketCount - 1);
+	histogram_[index].fetch_add(1, std::memory_order_relaxed);
+	samples_.fetch_add(1, std::memory_order_release);
+}
+
+void
+SyncJitterStatistics::recordOverruns(uint64_t missedPeriods)
+{
+	overruns_.fetch_add(missedPeriods, std::memory_order_relaxed);
+}
+
+auto
+SyncJitterStatistics::summary() const -> Summary
+{
+	Summary out{};
+	out.samples = samples_.load(std::memory_order_acquire);
+	out.overruns = overruns_.load(std::memory_order_relaxed);
+	if (out.samples == 0) { return out; }
+
+	out.min = std::chrono::nanoseconds{min_.load(std::memory_order_relaxed)};
+	out.max = std::chrono::nanoseconds{max_.load(std::memory_order_relaxed)};
+	out.mean =
+		std::chrono::nanoseconds{sum_.load(std::memory_order_relaxed) / int64_t(out.samples)};
+
+	// Buckets may be ahead of the sample counter while the producer is running, this only
+	// shifts the percentile by a sample at most
+	const uint64_t threshold = (out.samples * 99 + 99) / 100;
+	uint64_t cumulative = 0;
+	for (std::size_t i = 0; i < BucketCount; ++i)
+	{
+		cumulative += histogram_[i].load(std::memory_order_relaxed);
+		if (cumulative >= threshold)
+		{
+			out.p99 = std::min(BucketWidth * int64_t(i + 1), out.max);
+			break;
+		}
+	}
+	return out;
+}
+
+uint32_t
+SyncJitterStatistics::bucket(std::size_t index) const
+{
+	if (index >= BucketCount) { return 0; }
+	return histogram_[index].load(std::memory_order_relaxed);
+}
+
+void
+SyncJitterStatistics::reset()
+{
+	samples_.store(0, std::memory_order_relaxed);
+	overruns_.store(0, std::memory_order_relaxed);
+	sum_.store(0, std::memory_order_relaxed);
+	min_.store(INT64_MAX, std::memory_order_relaxed);
+	max_.store(0, std::memory_order_relaxed);
+	for (auto& bucket : histogram_) { bucket.store(0, std::memory_order_relaxed); }
+}
+
+TimerSyncProducer::~TimerSyncProducer() { stop(); }
+
+std::chrono::nanoseconds
+TimerSyncProducer::now()
+{
+	return std::chrono::nanoseconds{monotonicNow()};
+}
+
+bool
+TimerSyncProducer::start(std::chrono::microseconds period, Callback&& sendSync,
+						 int realtimePriority)
+{
+	if (running_ || period.count() <= 0) { return false; }
+
+	timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+	stopFd_ = eventfd(0, EFD_CLOEXEC);
+	if (timerFd_ < 0 || stopFd_ < 0)
+	{
+		MODM_LOG_ERROR << "Failed to create SYNC timer" << modm::endl;
+		stop();
+		return false;
+	}
+
+	running_ = true;
+	thread_ = std::thread(&TimerSyncProducer::run, this, period, std::move(sendSync));
+
+	if (realtimePriority > 0)
+	{
+		sched_param param{};
+		param.sched_priority = realtimePriority;
+		if (pthread_setschedparam(thread_.native_handle(), SCHED_FIFO, &param) != 0)
+		{
+			MODM_LOG_ERROR << "Failed to set SYNC thread priority, running without" << modm::endl;
+		}
+	}
+	return true;
+}
+
+void
+TimerSyncProducer::stop()
+{
+	if (thread_.joinable())
+	{
+		running_ = false;
+		const uint64_t wake = 1;
+		[[maybe_unused]] const auto written = write(stopFd_, &wake, sizeof(wake));
+		thread_.join();
+	}
+	running_ = false;
+	if (timerFd_ >= 0) { close(timerFd_); }
+	if (stopFd_ >= 0) { close(stopFd_); }
+	timerFd_ = -1;
+	stopFd_ = -1;
+}
+
+bool
+TimerSyncProducer::isRunning() const
+{
+	return running_;
+}
+
+const SyncJitterStatistics&
+TimerSyncProducer::statistics() const
+{
+	return statistics_;
+}
+
+void
+TimerSyncProducer::resetStatistics()
+{
+	statistics_.reset();
+}
+
+void
+TimerSyncProducer::run(std::chrono::nanoseconds period, Callback sendSync)
+{
+	int64_t deadline = monotonicNow() + period.count();
+	const itimerspec spec{.it_interval = toTimespec(period.count()),
+						  .it_value = toTimespec(deadline)};
+	if (timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr) != 0)
+	{
+		MODM_LOG_ERROR << "Failed to arm SYNC timer" << modm::endl;
+		running_ = false;
+		return;
+	}
+
+	std::array<pollfd, 2> fds{pollfd{.fd = timerFd_, .events = POLLIN, .revents = 0},
+							  pollfd{.fd = stopFd_, .events = POLLIN, .revents = 0}};
+	while (running_)
+	{
+		if (poll(fds.data(), fds.size(), -1) < 0) { continue; }
+		if (fds[1].revents & POLLIN) { break; }
+		if (!(fds[0].revents & POLLIN)) { continue; }
+
+		uint64_t expirations = 0;
+		if (read(timerFd_, &expirations, sizeof(expirations)) != sizeof(expirations)) { continue; }
+
+		// Several expirations at once means whole periods were skipped, SYNC is only sent once
+		if (expirations > 1) { statistics_.recordOverruns(expirations - 1); }
+		deadline += period.count() * int64_t(expirations - 1);
+
+		// Work the callback does after sending, e.g. for the TPDOs, is not included
+		const std::chrono::nanoseconds sent = sendSync();
+		statistics_.record(std::chrono::nanoseconds{sent.count() - deadline});
+		deadline += period.count();
+	}
+}
+
+}  // namespace modm_canopen
@@ -0,0 +1,105 @@
+#ifndef CANOPEN_SYNC_PRODUCER_HPP
+#define CANOPEN_SYNC_PRODUCER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace modm_canopen
+{
+
+/// Lateness of the produced SYNC messages relative to their ideal schedule, measured when the
+/// SYNC frame was handed to the bus.
+/// Written by the producer thread only, safe to read from any other thread.
+class SyncJitterStatistics
+{
+public:
+	static constexpr std::chrono::nanoseconds BucketWidth{std::chrono::microseconds{1}};
+	// Last bucket collects everything above BucketCount-1 microseconds
+	static constexpr std::size_t BucketCount = 1000;
+
+	struct Summary
+	{
+		uint64_t samples{};
+		uint64_t overruns{};
+		std::chrono::nanoseconds min{};
+		std::chrono::nanoseconds max{};
+		std::chrono::nanoseconds mean{};
+		std::chrono::nanoseconds p99{};  // upper bound of the bucket holding the 99th percentile
+	};
+
+	void
+	record(std::chrono::nanoseconds lateness);
+
+	void
+	recordOverruns(uint64_t missedPeriods);
+
+	Summary
+	summary() const;
+
+	uint32_t
+	bucket(std::size_t index) const;
+
+	void
+	reset();
+
+private:
+	std::atomic<uint64_t> samples_{0};
+	std::atomic<uint64_t> overruns_{0};
+	std::atomic<int64_t> sum_{0};
+	std::atomic<int64_t> min_{INT64_MAX};
+	std::atomic<int64_t> max_{0};
+	std::array<std::atomic<uint32_t>, BucketCount> histogram_{};
+};
+
+/// Calls a SYNC callback from its own thread, driven by an absolute CLOCK_MONOTONIC timerfd.
+/// Because every expiry is scheduled on an absolute time grid, late wake-ups do not accumulate.
+class TimerSyncProducer
+{
+public:
+	/// Sends the SYNC, returns now() taken right after the frame was handed to the bus
+	using Callback = std::function<std::chrono::nanoseconds()>;
+
+	/// CLOCK_MONOTONIC
+	static std::chrono::nanoseconds
+	now();
+
+	TimerSyncProducer() = default;
+	TimerSyncProducer(const TimerSyncProducer&) = delete;
+	TimerSyncProducer&
+	operator=(const TimerSyncProducer&) = delete;
+	~TimerSyncProducer();
+
+	/// realtimePriority > 0 runs the thread with SCHED_FIFO at that priority
+	bool
+	start(std::chrono::microseconds period, Callback&& sendSync, int realtimePriority = 0);
+
+	void
+	stop();
+
+	bool
+	isRunning() const;
+
+	const SyncJitterStatistics&
+	statistics() const;
+
+	void
+	resetStatistics();
+
+private:
+	void
+	run(std::chrono::nanoseconds period, Callback sendSync);
+
+	int timerFd_{-1};
+	int stopFd_{-1};
+	std::atomic<bool> running_{false};
+	std::thread thread_{};
+	SyncJitterStatistics statistics_{};
+};
+
+}  // namespace modm_canopen
+
+#endif  // CANOPEN_SYNC_PRODUCER_HPP
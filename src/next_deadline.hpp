@@ -0,0 +1,52 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <type_traits>
+#include <modm/architecture/interface/clock.hpp>
+
+namespace modm_canopen
+{
+
+/// Earliest of several deadlines. Deadlines are kept relative to now, so comparing them stays
+/// valid across wrap-arounds of the PreciseClock.
+class NextDeadline
+{
+public:
+	using time_point = modm::PreciseClock::time_point;
+	using duration = modm::PreciseClock::duration;
+
+	NextDeadline(time_point now, duration maximum) : now_{now}, remaining_{maximum} {}
+
+	/// Deadlines in the past mean immediately
+	void
+	add(time_point deadline)
+	{
+		using SignedRep = std::make_signed_t<modm::PreciseClock::rep>;
+		const auto remaining = SignedRep((deadline - now_).count());
+		if (remaining <= 0)
+		{
+			remaining_ = duration{0};
+		} else
+		{
+			remaining_ = std::min(remaining_, duration(remaining));
+		}
+	}
+
+	void
+	addNow()
+	{
+		remaining_ = duration{0};
+	}
+
+	time_point
+	value() const
+	{
+		return now_ + remaining_;
+	}
+
+private:
+	time_point now_;
+	duration remaining_;
+};
+
+}  // namespace modm_canopen
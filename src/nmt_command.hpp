@@ -7,12 +7,13 @@ enum class NMTCommand : uint8_t
 	Start = 1,
 	Stop = 2,
 	EnterPreOperational = 128,
-	ResetNode = 129
+	ResetNode = 129,
+	ResetCommunication = 130
 };
 
 static inline bool
 isValidNMTCommand(uint8_t val)
 {
-	return val == 1 || val == 2 || val == 128 || val == 129;
+	return val == 1 || val == 2 || val == 128 || val == 129 || val == 130;
 }
 }  // namespace modm_canopen
\ No newline at end of file
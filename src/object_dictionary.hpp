@@ -37,7 +37,30 @@ writableEntryCount()
 	return std::transform_reduce(Map::map.begin(), Map::map.end(), 0u, std::plus<>{}, isWritable);
 }
 
-inline size_t
+/// Position of address in the sorted OD::map, for arrays with one element per object
+template<typename OD>
+constexpr std::optional<std::size_t>
+entryIndex(Address address)
+{
+	const auto begin = OD::map.begin();
+	const auto end = begin + OD::map.size();
+	const auto it = std::lower_bound(
+		begin, end, address, [](const auto& element, Address key) { return element.first < key; });
+	if (it == end || it->first != address) return {};
+	return std::size_t(it - begin);
+}
+
+/// Number of sub-entries 1..N of an array object
+template<typename OD>
+constexpr std::size_t
+subEntryCount(uint16_t index)
+{
+	return std::count_if(OD::map.begin(), OD::map.end(), [index](const auto& element) {
+		return element.first.index == index && element.first.subindex != 0;
+	});
+}
+
+constexpr size_t
 getDataTypeSize(DataType type)
 {
 	switch (type)
@@ -42,6 +42,15 @@ enum class AccessType : uint8_t
 using Value = std::variant<std::monostate, uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t,
 						   int32_t, int64_t, float32_t>;
 
+/// Object known at compile time, generated per EDS by od_generator.py --objects
+template<Address A, DataType T>
+struct TypedObject
+{
+	static constexpr Address address = A;
+	static constexpr DataType dataType = T;
+	using Type = std::variant_alternative_t<static_cast<std::size_t>(T), Value>;
+};
+
 struct Entry
 {
 	Address address;
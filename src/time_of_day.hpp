@@ -0,0 +1,57 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <span>
+
+namespace modm_canopen
+{
+/// CiA 301 TIME_OF_DAY as sent by the TIME service
+struct TimeOfDay
+{
+	uint32_t milliseconds{};  // after midnight, 28 bit
+	uint16_t days{};          // since 1984-01-01
+
+	static constexpr std::chrono::sys_days Epoch{std::chrono::year{1984} / std::chrono::January / 1};
+	static constexpr std::size_t Size = 6;
+
+	static constexpr TimeOfDay
+	fromSinceEpoch(std::chrono::milliseconds sinceEpoch)
+	{
+		const auto days = std::chrono::floor<std::chrono::days>(sinceEpoch);
+		return TimeOfDay{.milliseconds = uint32_t((sinceEpoch - days).count()) & 0x0FFF'FFFF,
+						 .days = uint16_t(days.count())};
+	}
+
+	static TimeOfDay
+	fromSystemClock(std::chrono::system_clock::time_point time)
+	{
+		return fromSinceEpoch(std::chrono::floor<std::chrono::milliseconds>(time - Epoch));
+	}
+
+	constexpr std::chrono::milliseconds
+	sinceEpoch() const
+	{
+		return std::chrono::days{days} + std::chrono::milliseconds{milliseconds};
+	}
+
+	constexpr void
+	encode(std::span<uint8_t, Size> out) const
+	{
+		out[0] = milliseconds & 0xFF;
+		out[1] = (milliseconds >> 8) & 0xFF;
+		out[2] = (milliseconds >> 16) & 0xFF;
+		out[3] = (milliseconds >> 24) & 0x0F;
+		out[4] = days & 0xFF;
+		out[5] = (days >> 8) & 0xFF;
+	}
+
+	static constexpr TimeOfDay
+	decode(std::span<const uint8_t, Size> data)
+	{
+		return TimeOfDay{.milliseconds = (data[0] | (data[1] << 8) | (data[2] << 16) |
+										  (uint32_t(data[3]) << 24)) &
+										 0x0FFF'FFFF,
+						 .days = uint16_t(data[4] | (data[5] << 8))};
+	}
+};
+}  // namespace modm_canopen
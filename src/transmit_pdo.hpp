@@ -2,6 +2,7 @@
 #define CANOPEN_TRANSMIT_PDO_HPP
 
 #include "pdo_common.hpp"
+#include "next_deadline.hpp"
 #include <array>
 #include <modm/architecture/interface/can_message.hpp>
 #include <modm/architecture/interface/clock.hpp>
@@ -41,6 +42,20 @@ struct SendOnEvent
 		}
 		return false;
 	}
+
+	void
+	addDeadlines(NextDeadline &deadline) const
+	{
+		// send() compares with >, a message is only due one tick after the interval
+		constexpr modm::PreciseDuration Tick{1};
+		if (updated_)
+		{
+			deadline.add(lastMessage_ + inhibitTime_ + Tick);
+		} else if (eventTimeout_.count() != 0)
+		{
+			deadline.add(lastMessage_ + std::max(eventTimeout_, inhibitTime_) + Tick);
+		}
+	}
 };
 
 template<typename OD>
@@ -67,6 +82,10 @@ public:
 	void
 	processMessage(const modm::can::Message &msg, ReadCallback &&read, MessageCallback &&cb);
 
+	/// Event timer and inhibit time, transmissions triggered by SYNC or RTR frames have none
+	void
+	addDeadlines(NextDeadline &deadline) const;
+
 	bool
 	setTransmitMode(uint8_t mode);
 
@@ -79,6 +79,17 @@ TransmitPdo<OD>::nextMessage(bool inSync, Callback &&cb)
 	}
 }
 
+template<typename OD>
+void
+TransmitPdo<OD>::addDeadlines(NextDeadline &deadline) const
+{
+	const auto mode = PdoObject<OD>::getTransmitMode();
+	if (mode.isAsync() || (mode.value == 0 && hasReceivedSync_))
+	{
+		sendOnEvent_.addDeadlines(deadline);
+	}
+}
+
 template<typename OD>
 bool
 TransmitPdo<OD>::setTransmitMode(uint8_t mode)
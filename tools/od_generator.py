@@ -34,32 +34,36 @@ class AccessType(Enum):
     ReadWriteWritePdo = "rww"
     Const = "const"
 
-Entry = namedtuple("Entry", "name address data_type access_type pdo_mapping")
+Entry = namedtuple("Entry", "name address data_type access_type pdo_mapping parent_name",
+                   defaults=(None,))
 Address = namedtuple("Address", "index subindex")
 
 
 def main():
-    argc = len(sys.argv)
-    if argc not in (2, 3):
-        print("Usage: od_generator [eds filename] [output file]", file=sys.stderr)
+    args = [arg for arg in sys.argv[1:] if arg != "--objects"]
+    objects = len(args) != len(sys.argv) - 1
+    if len(args) not in (1, 2):
+        print("Usage: od_generator [--objects] [eds filename] [output file]", file=sys.stderr)
         sys.exit(1)
 
-    header_data = generate_data_header(sys.argv[1])
-    if argc == 2 or sys.argv[2] == "-":
+    header_data = generate_data_header(args[0], objects)
+    if len(args) == 1 or args[1] == "-":
         sys.stdout.write(header_data)
     else:
-        with open(sys.argv[2], "wt") as out:
+        with open(args[1], "wt") as out:
             out.write(header_data)
 
 
-def generate_data_header(eds_filename):
+def generate_data_header(eds_filename, objects=False):
     env = create_jinja2_env()
     env.template = env.get_template("od_data.hpp.j2")
     eds = load_eds_file(eds_filename)
     entries = read_all_objects(eds)
     name = Path(eds_filename).stem
     name = re.sub(r'[^\w]', '', name) +"_OD"
-    return env.template.render({"name": name ,"entries" : entries, "entry_count" : len(entries)})
+    typed_objects = object_identifiers(entries) if objects else []
+    return env.template.render({"name": name ,"entries" : entries, "entry_count" : len(entries),
+                                "objects" : typed_objects})
 
 
 def key_to_address(key):
@@ -103,7 +107,7 @@ def read_objects_from_section(eds, section):
     return objects
 
 
-def read_object(eds, key, recursive=True):
+def read_object(eds, key, recursive=True, parent_name=None):
     obj = eds[key]
     object_type = ObjectType(parse_eds_number(obj["ObjectType"]))
     if object_type == ObjectType.VAR:
@@ -116,7 +120,7 @@ def read_object(eds, key, recursive=True):
         access_type = AccessType(obj["AccessType"])
         mapping = bool(parse_eds_number(obj["PDOMapping"]))
         name = obj["ParameterName"].strip()
-        return [Entry(name, key_to_address(key), data_type, access_type, mapping)]
+        return [Entry(name, key_to_address(key), data_type, access_type, mapping, parent_name)]
     elif object_type in (ObjectType.RECORD, ObjectType.ARRAY):
         if not recursive:
             raise ValueError("Key {} is not a value".format(key))
@@ -125,7 +129,8 @@ def read_object(eds, key, recursive=True):
         for subindex in range(0, subobject_count):
             subkey = key + "sub" + str(subindex)
             if subkey in eds:
-                subobjects.append(read_object(eds, subkey, False)[0])
+                parent_name = obj["ParameterName"].strip()
+                subobjects.append(read_object(eds, subkey, False, parent_name)[0])
         return subobjects
     else:
         raise ValueError("Unsupported object type '{}'".format(str(object_type)))
@@ -179,6 +184,29 @@ def check_entries(entries):
         address_set.add(entry.address)
 
 
+def to_identifier(name):
+    words = re.split(r'[^0-9a-zA-Z]+', name)
+    identifier = "".join(word[0].upper() + word[1:] for word in words if word)
+    if not identifier or identifier[0].isdigit():
+        identifier = "Object" + identifier
+    return identifier
+
+
+def object_identifiers(entries):
+    """C++ type names for all entries, sub-objects are prefixed with the name of their object"""
+    objects = []
+    used = set()
+    for entry in entries:
+        identifier = to_identifier(entry.name)
+        if entry.parent_name is not None:
+            identifier = to_identifier(entry.parent_name) + "_" + identifier
+        if identifier in used:
+            identifier += "_{:X}_{}".format(entry.address.index, entry.address.subindex)
+        used.add(identifier)
+        objects.append((identifier, entry))
+    return objects
+
+
 def create_jinja2_env():
     loader = jinja2.FileSystemLoader(Path(__file__).resolve().parent)
     env = jinja2.Environment(loader=loader)